@@ -21,6 +21,7 @@
 #include "MessageBar.h"
 #include "MainWindow.h"
 #include "LevelView.h"
+#include "MiniMap.h"
 #include "RoomView.h"
 #include "ControllerView.h"
 #include "ControlView.h"
@@ -81,10 +82,10 @@ void Enigma::Application::on_activate()
 	m_view->set_halign(Gtk::ALIGN_START);
 	m_view->set_hexpand(false);
 
-	Enigma::MessageBar* message = Gtk::manage(new Enigma::MessageBar);
-	m_grid->attach(*message, 1, 1, 1, 1);
-	message->set_padding(0, 3);
-	message->set_hexpand(true);
+	m_message = Gtk::manage(new Enigma::MessageBar);
+	m_grid->attach(*m_message, 1, 1, 1, 1);
+	m_message->set_padding(0, 3);
+	m_message->set_hexpand(true);
 
 	m_viewbook = std::make_unique<Gtk::Notebook>();
 	m_grid->attach(*m_viewbook, 0, 2, 2, 1);
@@ -93,8 +94,20 @@ void Enigma::Application::on_activate()
 
 	// Add viewer pages to the view notebook.
 
-	m_levelview        = std::make_unique<Enigma::LevelView>();
-	m_levelview_number = m_viewbook->append_page(*m_levelview);
+	// The LevelView page has a MiniMap of the whole level beside it, and
+	// a second LevelView pane for viewing another level (shown by F9).
+	// Both panes share one editing buffer.
+
+	m_levelview = std::make_unique<Enigma::LevelView>();
+	m_levelpane = std::make_unique<Enigma::LevelView>();
+	m_minimap   = std::make_unique<Enigma::MiniMap>();
+	m_levelpage = std::make_unique<Gtk::Grid>();
+	m_levelpage->attach(*m_levelview, 0, 0, 1, 1);
+	m_levelpage->attach(*m_levelpane, 1, 0, 1, 1);
+	m_levelpage->attach(*m_minimap, 2, 0, 1, 1);
+	m_levelpane->set_no_show_all(true);
+	m_levelpane->set_edit_buffer(m_levelview->get_edit_buffer());
+	m_levelview_number = m_viewbook->append_page(*m_levelpage);
 
 	m_roomview        = std::make_unique<Enigma::RoomView>();
 	m_roomview_number = m_viewbook->append_page(*m_roomview);
@@ -126,6 +139,7 @@ void Enigma::Application::on_activate()
 	m_world = std::make_shared<Enigma::World>();
 
 	m_levelview->set_world(m_world);
+	m_levelpane->set_world(m_world);
 	m_roomview->set_world(m_world);
 	m_teleporterview->set_world(m_world);  
 	m_itemview->set_world(m_world);
@@ -138,7 +152,7 @@ void Enigma::Application::on_activate()
 	// display the current map location.
 
 	m_levelview->signal_position()
-		.connect(sigc::mem_fun(*message, &Enigma::MessageBar::set_position));
+		.connect(sigc::mem_fun(*m_message, &Enigma::MessageBar::set_position));
 
 	// Connect the LevelView widget to the RoomView widget to update
 	// its current map location.
@@ -146,30 +160,82 @@ void Enigma::Application::on_activate()
 	m_levelview->signal_position()
 		.connect(sigc::mem_fun(*m_roomview, &Enigma::RoomView::set_position));
 
+	// Connect the second LevelView pane to the MessageBar and RoomView
+	// widgets in the same way.
+
+	m_levelpane->signal_position()
+		.connect(sigc::mem_fun(*m_message, &Enigma::MessageBar::set_position));
+
+	m_levelpane->signal_position()
+		.connect(sigc::mem_fun(*m_roomview, &Enigma::RoomView::set_position));
+
+	// Rooms edited in either LevelView pane are updated in the other views.
+
+	m_levelview->signal_changed()
+		.connect(sigc::bind(
+			sigc::mem_fun(*this, &Enigma::Application::on_level_changed),
+			m_levelview.get()));
+
+	m_levelpane->signal_changed()
+		.connect(sigc::bind(
+			sigc::mem_fun(*this, &Enigma::Application::on_level_changed),
+			m_levelpane.get()));
+
+	// Messages from either LevelView pane, such as a refused edit, are
+	// shown on the MessageBar.
+
+	m_levelview->signal_message()
+		.connect(sigc::mem_fun(*m_message, &Enigma::MessageBar::set_label));
+
+	m_levelpane->signal_message()
+		.connect(sigc::mem_fun(*m_message, &Enigma::MessageBar::set_label));
+
+	// Connect the LevelView widget to the MiniMap widget, so it shows the
+	// level summary, view and cursor.  Clicking the MiniMap moves the
+	// LevelView cursor.
+
+	m_levelview->signal_summary()
+		.connect(sigc::mem_fun(*m_minimap, &Enigma::MiniMap::set_summary));
+
+	m_levelview->signal_view()
+		.connect(sigc::mem_fun(*m_minimap, &Enigma::MiniMap::set_view));
+
+	m_levelview->signal_position()
+		.connect(sigc::mem_fun(*m_minimap, &Enigma::MiniMap::set_position));
+
+	m_minimap->signal_position()
+		.connect(sigc::mem_fun(*m_levelview, &Enigma::LevelView::set_cursor));
+
 	// Connect the TeleporterView widget to the MessageBar widget so it will
 	// display the teleporter's map location.
 
 	m_teleporterview->signal_position()
-		.connect(sigc::mem_fun(*message, &Enigma::MessageBar::set_position));
+		.connect(sigc::mem_fun(*m_message, &Enigma::MessageBar::set_position));
 
 	// Connect the ItemView widget to the MessageBar widget so it will
 	// display the item's map location.
 
 	m_itemview->signal_position()
-		.connect(sigc::mem_fun(*message, &Enigma::MessageBar::set_position));
+		.connect(sigc::mem_fun(*m_message, &Enigma::MessageBar::set_position));
 
 	// Connect the PlayerView widget to the MessageBar widget so it will
 	// display the player's map location.
 
 	m_playerview->signal_position()
-		.connect(sigc::mem_fun(*message, &Enigma::MessageBar::set_position));
+		.connect(sigc::mem_fun(*m_message, &Enigma::MessageBar::set_position));
 
 	// Connect the ControllerView widget to the MessageBar widget so it will
 	// display the current controller name.
 
 	m_controllerview->signal_name()
-		.connect(sigc::mem_fun(*message, &Enigma::MessageBar::set_label));
+		.connect(sigc::mem_fun(*m_message, &Enigma::MessageBar::set_label));
 	                          	
+	// Connect the world loading thread's completion signal.
+
+	m_load_done.connect(sigc::mem_fun(*this, &Enigma::Application::on_load_done));
+	m_reload_done.connect(sigc::mem_fun(*this, &Enigma::Application::on_reload_done));
+	m_reload_again = false;
+
 	// Open the main window showing the help viewer.
 
 	m_window->maximize();
@@ -596,7 +662,12 @@ void Enigma::Application::on_command(const Glib::ustring& command)
         // Update the appropriate view.
 			
         if (m_viewbook->get_current_page() == m_levelview_number)
-          m_levelview->update();
+        {
+          std::list<Enigma::Position> positions(1, object.m_position);
+
+          m_levelview->update(positions);
+          m_levelpane->update(positions);
+        }
         else if (m_viewbook->get_current_page() == m_roomview_number)
           m_roomview->update();
         else if (m_viewbook->get_current_page() == m_itemview_number)
@@ -627,30 +698,15 @@ void Enigma::Application::on_command(const Glib::ustring& command)
         // No filename is provided, so load using the world's internal
         // filename.
         
-        m_world->load();
+        load(m_world->m_filename);
       }
       else if (total == 2)
       {
-        // A filename is provided, so update the world's internal name
-        // to be used for loading.
-      
-        m_world->m_filename = arguments.at(1);
-        m_world->load();
+        // A filename is provided, so load a world with this name.  The
+        // window title is updated once loading is done.
       
-        // Report the game world filename in the window title.
-
-        m_window->set_title_message(m_world->m_filename);
+        load(arguments.at(1));
       }
-      
-      // Reset the ControllerView.
-      
-      m_controllerview->reset();
-      
-      // Switch to the LevelView.
-      
-      m_view->set_label(_("[ Map Level ]"));
-      m_viewbook->set_current_page( m_levelview_number);
-      m_levelview->home();
     }
     else if (arguments.at(0).compare(_("s")) == 0)
     {
@@ -669,10 +725,18 @@ void Enigma::Application::on_command(const Glib::ustring& command)
         m_world->m_filename = arguments.at(1);
         m_world->save();
       
-        // Report the game world filename in the window title.
+        // Report the game world filename in the window title, and watch
+        // the new file for changes.
       
         m_window->set_title_message(m_world->m_filename);
+        watch();
       }
+
+      // A changed file being read is older than the world just saved, so
+      // it must not be applied.  Read the file again once it is done.
+
+      if (m_reloading)
+        m_reload_again = true;
     }
     else if (arguments.at(0).compare(_("n")) == 0)
     {    
@@ -691,6 +755,10 @@ void Enigma::Application::on_command(const Glib::ustring& command)
       }
      
       m_world->clear();
+      m_levelview->set_world(m_world);
+      m_levelpane->set_world(m_world);
+      m_levelpane->update();
+      watch();
       
       // Reset the ControllerView.
       
@@ -874,6 +942,7 @@ void Enigma::Application::on_command(const Glib::ustring& command)
       }
 
       m_levelview->set_filter(filter);          
+      m_levelpane->set_filter(filter);
     }
     else if (arguments.at(0).compare(_("q")) == 0)
       quit();
@@ -898,7 +967,13 @@ bool Enigma::Application::on_key_press(GdkEventKey* key_event)
   bool handled  = true;	
   int key_value = key_event->keyval;
 
-  if (key_value == GDK_KEY_F1)
+  if ((key_value == GDK_KEY_Escape) && m_loading)
+  {
+    // Cancel loading a world.  The loading thread stops soon afterwards.
+
+    m_loading->m_cancel = true;
+  }
+  else if (key_value == GDK_KEY_F1)
   {
     if (m_viewbook->get_current_page() == m_roomview_number)
     {
@@ -1002,16 +1077,364 @@ bool Enigma::Application::on_key_press(GdkEventKey* key_event)
       m_viewbook->set_current_page(m_helpview_number);
     }
   }
+  else if (key_value == GDK_KEY_F9)
+  {
+    // Show or hide the second LevelView pane.  It first shows the level
+    // above the cursor of the first pane.
+
+    if (m_levelpane->get_visible())
+    {
+      m_levelpane->hide();
+      m_levelview->grab_focus();
+    }
+    else
+    {
+      Enigma::Position position = m_levelview->get_cursor();
+
+      if (position.m_above < Enigma::Position::MAXIMUM)
+        ++ position.m_above;
+
+      m_view->set_label(_("[ Map Level ]"));
+      m_viewbook->set_current_page(m_levelview_number);
+      m_levelpane->show();
+      m_levelpane->set_cursor(position);
+    }
+  }
   else
     handled = false;
 		
 	return handled;
 }
 
+//---------------------------------------------------------------------
+// This private method is called when rooms have been edited in a
+// LevelView pane.  The other views draw only those rooms again.  The
+// pane that made the change has already done so.
+//---------------------------------------------------------------------
+// positions: Positions of changed rooms.
+// source:    LevelView pane that made the change.
+//---------------------------------------------------------------------
+
+void Enigma::Application::on_level_changed(
+	const std::list<Enigma::Position>& positions,
+	Enigma::LevelView* source)
+{
+	if (m_levelview.get() != source)
+		m_levelview->update(positions);
+
+	if (m_levelpane.get() != source)
+		m_levelpane->update(positions);
+
+	m_roomview->update(positions);
+}
+
 //---------------------------------------------------------
 // This method is called when application is shutting down.
 //---------------------------------------------------------
 
 void Enigma::Application::do_shutdown()
 {
+	// Stop any world loading thread.
+
+	if (m_load_thread.joinable())
+	{
+		m_loading->m_cancel = true;
+		m_load_thread.join();
+	}
+
+	if (m_reload_thread.joinable())
+	{
+		m_reloading->m_cancel = true;
+		m_reload_thread.join();
+	}
+}
+
+//--------------------------------------------------------------------
+// This private method begins loading a world on a separate thread, so
+// the window remains responsive.  The current world remains in use
+// until the new world has loaded successfully.
+//--------------------------------------------------------------------
+// filename: Name of world file.
+//--------------------------------------------------------------------
+
+void Enigma::Application::load(const Glib::ustring& filename)
+{
+	// Only one world is loaded at a time.  Say so, and hold back the
+	// progress report for a couple of seconds so the message is seen.
+
+	if (m_loading)
+	{
+		m_message->set_label(
+			Glib::ustring::compose(_("Already loading %1   (Esc to cancel)"),
+			                       m_loading->m_filename));
+
+		m_load_progress.disconnect();
+		m_load_progress = Glib::signal_timeout().connect(
+			sigc::mem_fun(*this, &Enigma::Application::on_load_notice), 2000);
+
+		return;
+	}
+
+	m_loading = std::make_shared<Enigma::World>();
+	m_loading->m_filename = filename;
+
+	m_load_thread = std::thread([this]()
+	{
+		m_load_result = m_loading->load();
+		m_load_done.emit();
+	});
+
+	// Report loading progress several times a second.
+
+	m_load_progress = Glib::signal_timeout().connect(
+		sigc::mem_fun(*this, &Enigma::Application::on_load_progress), 100);
+
+	on_load_progress();
+}
+
+//----------------------------------------------------------
+// This private method reports the progress of world loading.
+//----------------------------------------------------------
+// RETURN: TRUE to continue reporting progress.
+//----------------------------------------------------------
+
+bool Enigma::Application::on_load_progress()
+{
+	m_message->set_progress(m_loading->m_filename,
+	                        m_loading->m_load_index,
+	                        m_loading->m_load_size);
+	return true;
+}
+
+//---------------------------------------------------------------
+// This private method resumes reporting the progress of world
+// loading, once a notice on the message bar has been shown.
+//---------------------------------------------------------------
+// RETURN: FALSE, so the notice timeout is not repeated.
+//---------------------------------------------------------------
+
+bool Enigma::Application::on_load_notice()
+{
+	m_load_progress = Glib::signal_timeout().connect(
+		sigc::mem_fun(*this, &Enigma::Application::on_load_progress), 100);
+
+	on_load_progress();
+	return false;
+}
+
+//---------------------------------------------------------------------
+// This private method is called (through a dispatcher) when the world
+// loading thread is done.  A successfully loaded world replaces the
+// current world in all viewers.
+//---------------------------------------------------------------------
+
+void Enigma::Application::on_load_done()
+{
+	m_load_thread.join();
+	m_load_progress.disconnect();
+
+	std::shared_ptr<Enigma::World> world = m_loading;
+	m_loading.reset();
+
+	if (!m_load_result)
+	{
+		// Keep the current world, and report why the new world is absent.
+
+		if (world->m_cancel)
+			m_message->set_label(_("Loading cancelled"));
+		else
+			m_message->set_label(
+				Glib::ustring::compose(_("Unable to load %1"), world->m_filename));
+
+		return;
+	}
+
+	m_world = world;
+
+	m_levelview->set_world(m_world);
+	m_levelpane->set_world(m_world);
+	m_roomview->set_world(m_world);
+	m_teleporterview->set_world(m_world);  
+	m_itemview->set_world(m_world);
+	m_playerview->set_world(m_world);
+	m_controllerview->set_world(m_world);
+	m_controlview->set_world(m_world);
+	m_descriptionview->set_world(m_world);
+
+	// Report the game world filename in the window title.
+
+	m_window->set_title_message(m_world->m_filename);
+
+	// Reset the ControllerView.
+
+	m_controllerview->reset();
+
+	// Switch to the LevelView.
+
+	m_view->set_label(_("[ Map Level ]"));
+	m_viewbook->set_current_page( m_levelview_number);
+	m_levelview->home();
+
+	// Watch for changes to the world file made by other programs.
+
+	watch();
+}
+
+//-------------------------------------------------------------------
+// This private method begins monitoring the world file for changes
+// made by other programs, replacing any previous monitor.
+//-------------------------------------------------------------------
+
+void Enigma::Application::watch()
+{
+	if (m_monitor)
+	{
+		m_monitor->cancel();
+		m_monitor.reset();
+	}
+
+	if (m_world->m_filename.empty())
+		return;
+
+	try
+	{
+		Glib::RefPtr<Gio::File> file =
+			Gio::File::create_for_path(m_world->m_filename);
+
+		m_monitor = file->monitor_file();
+		m_monitor->signal_changed().connect(
+			sigc::mem_fun(*this, &Enigma::Application::on_file_changed));
+	}
+	catch(Glib::Error error)
+	{
+	}
+}
+
+//---------------------------------------------------------------------
+// This private method is called when the world file has been changed.
+// The file is read again on a separate thread.
+//---------------------------------------------------------------------
+// file:       World file.
+// other_file: Unused.
+// event:      Type of change.
+//---------------------------------------------------------------------
+
+void Enigma::Application::on_file_changed(
+	const Glib::RefPtr<Gio::File>& file,
+	const Glib::RefPtr<Gio::File>& other_file,
+	Gio::FileMonitorEvent event)
+{
+	// Wait until the file has been completely written.  A file replaced by
+	// renaming another file appears as a new file.  Changes are ignored
+	// while a world is being loaded, since it will replace this one.
+
+	if (((event != Gio::FILE_MONITOR_EVENT_CHANGES_DONE_HINT)
+	     && (event != Gio::FILE_MONITOR_EVENT_CREATED))
+	    || m_loading)
+	{
+		return;
+	}
+
+	// A file just saved by this program is left as it was recorded when
+	// written, so it is not read again.
+
+	if (!m_world->is_file_changed())
+		return;
+
+	reload();
+}
+
+//---------------------------------------------------------------------
+// This private method begins reading the changed world file on a
+// separate thread, so the window remains responsive.  If the file
+// changes again while it is being read, it is read again afterwards.
+//---------------------------------------------------------------------
+
+void Enigma::Application::reload()
+{
+	if (m_reloading)
+	{
+		m_reload_again = true;
+		return;
+	}
+
+	m_reload_again = false;
+	m_reload_world = m_world;
+
+	m_reloading = std::make_shared<Enigma::World>();
+	m_reloading->m_filename = m_world->m_filename;
+
+	std::set<unsigned short> unloaded = m_world->get_unloaded_levels();
+
+	m_reload_thread = std::thread([this, unloaded]()
+	{
+		m_reload_result = m_reloading->load_latest(unloaded);
+		m_reload_done.emit();
+	});
+}
+
+//---------------------------------------------------------------------
+// This private method is called (through a dispatcher) when the changed
+// world file has been read.  Only the differences from the current world
+// are applied, so viewers keep their cursor and position, and redraw
+// only the changed rooms.
+//---------------------------------------------------------------------
+
+void Enigma::Application::on_reload_done()
+{
+	m_reload_thread.join();
+
+	std::shared_ptr<Enigma::World> latest = m_reloading;
+	std::shared_ptr<Enigma::World> world = m_reload_world;
+
+	m_reloading.reset();
+	m_reload_world.reset();
+
+	// A world loaded in the meantime has replaced the one read for.
+
+	if (world != m_world)
+		return;
+
+	if (m_reload_again)
+	{
+		reload();
+		return;
+	}
+
+	if (!m_reload_result)
+	{
+		// The file may be partly written, so it no longer matches the hash.
+
+		m_world->m_file_hash = 0;
+		return;
+	}
+
+	Enigma::World::Changes changes;
+	m_world->reload(*latest, changes);
+
+	m_levelview->update(changes.m_positions);
+	m_levelpane->update(changes.m_positions);
+	m_roomview->update(changes.m_positions);
+
+	if (changes.m_lists)
+	{
+		m_teleporterview->update();
+		m_itemview->update();
+		m_playerview->update();
+	}
+
+	if (changes.m_controllers)
+	{
+		// A controller being edited may have been removed, so return to the
+		// controller list.
+
+		m_controllerview->reset();
+		m_controllerview->update();
+	}
+
+	if (changes.m_description)
+	{
+		m_descriptionview->update();
+		m_controlview->update();
+	}
 }
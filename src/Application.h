@@ -25,6 +25,12 @@
 #include <gtkmm/grid.h>
 #include <gtkmm/notebook.h>
 #include <gdkmm/event.h>
+#include <glibmm/dispatcher.h>
+#include <giomm/file.h>
+#include <giomm/filemonitor.h>
+#include <thread>
+#include <list>
+#include "Position.h"
 
 namespace Enigma
 {
@@ -32,6 +38,7 @@ namespace Enigma
 	class MainWindow;
 	class CommandEntry;
 	class LevelView;
+	class MiniMap;
 	class RoomView;
 	class TeleporterView;
 	class ItemView;
@@ -40,6 +47,7 @@ namespace Enigma
 	class ControlView;
 	class DescriptionView;
 	class HelpView;
+	class MessageBar;
 	
 	class Application : public Gtk::Application
 	{
@@ -56,6 +64,22 @@ namespace Enigma
 			void on_activate() override;
 
 		private:
+			// Private methods.
+
+			void load(const Glib::ustring& filename);
+			bool on_load_progress();
+			bool on_load_notice();
+			void on_load_done();
+			void watch();
+			void reload();
+			void on_reload_done();
+			void on_level_changed(const std::list<Enigma::Position>& positions,
+			                      Enigma::LevelView* source);
+
+			void on_file_changed(const Glib::RefPtr<Gio::File>& file,
+			                     const Glib::RefPtr<Gio::File>& other_file,
+			                     Gio::FileMonitorEvent event);
+
 			// Private data.
 
 			std::shared_ptr<Enigma::World> m_world;
@@ -64,10 +88,35 @@ namespace Enigma
 			std::unique_ptr<Enigma::CommandEntry> m_command;
 			std::unique_ptr<Gtk::Label> m_view;
 			std::unique_ptr<Gtk::Notebook> m_viewbook;
+			Enigma::MessageBar* m_message;
+
+			// World loading thread.
+
+			std::shared_ptr<Enigma::World> m_loading;   // World being loaded.
+			std::thread m_load_thread;                  // Loading thread.
+			bool m_load_result;                         // TRUE if loaded.
+			Glib::Dispatcher m_load_done;               // Loading done signal.
+			sigc::connection m_load_progress;           // Progress timeout.
+
+			// Monitor of world file changes made by other programs.
+
+			Glib::RefPtr<Gio::FileMonitor> m_monitor;
+
+			// World file reading thread, after the file has changed.
+
+			std::shared_ptr<Enigma::World> m_reloading;  // Changed world file.
+			std::shared_ptr<Enigma::World> m_reload_world;  // World read for.
+			std::thread m_reload_thread;                 // Reading thread.
+			bool m_reload_result;                        // TRUE if read.
+			bool m_reload_again;                         // TRUE if changed again.
+			Glib::Dispatcher m_reload_done;              // Reading done signal.
 
 			// Map viewers.
 
+			std::unique_ptr<Gtk::Grid> m_levelpage;
 			std::unique_ptr<Enigma::LevelView> m_levelview;
+			std::unique_ptr<Enigma::LevelView> m_levelpane;
+			std::unique_ptr<Enigma::MiniMap> m_minimap;
 			std::unique_ptr<Enigma::RoomView> m_roomview;
 			std::unique_ptr<Enigma::TeleporterView> m_teleporterview;    
 			std::unique_ptr<Enigma::ItemView> m_itemview;
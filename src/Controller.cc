@@ -154,7 +154,7 @@ void Enigma::Controller::compile(const Glib::ustring& sourcecode)
 	std::string bytecode;
 	bool restart_code = true;
 	bool update_jump;
-	guint jump_index;
+	guint jump_index = 0;
 
 	// Split the sourcecode into lines.
 
@@ -167,7 +167,7 @@ void Enigma::Controller::compile(const Glib::ustring& sourcecode)
 	     ++ line_index)
 	{    
 		bytecode.clear();
-		update_jump = true;
+		update_jump = false;
 
 		// Split a sourcecode line into parts separated by one or more spaces.
 
@@ -411,3 +411,18 @@ void Enigma::Controller::uncompile(std::string& bytecode,
 		}
 	}
 }
+
+//---------------------------------------------------------
+// This method returns TRUE if two controllers are the same.
+//---------------------------------------------------------
+// controller: Controller to be compared.
+// RETURN:     TRUE if the controllers are the same.
+//---------------------------------------------------------
+
+bool Enigma::Controller::operator==(const Enigma::Controller& controller) const
+{
+	return ((m_name == controller.m_name)
+	        && (m_signal_names == controller.m_signal_names)
+	        && (m_restart_code == controller.m_restart_code)
+	        && (m_main_code == controller.m_main_code));
+}
@@ -53,6 +53,7 @@ namespace Enigma
 			Controller(const std::string& name);
 			void compile(const Glib::ustring& sourcecode);
 			void uncompile(Glib::ustring& sourcecode);
+			bool operator==(const Enigma::Controller& controller) const;
 
 			// Public data.
 
@@ -18,6 +18,7 @@
 // with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <glibmm/i18n.h>
+#include <gtkmm/dialog.h>
 #include "ControllerView.h"
 #include "World.h"
 
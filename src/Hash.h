@@ -0,0 +1,117 @@
+// "World in the Wine Cellar" world creator for "Enigma in the Wine Cellar".
+// Copyright (C) 2021 Chris Sterne <chris_sterne@hotmail.com>
+//
+// This file contains the Hash class header.  The Hash class computes a 64-bit
+// hash of data (similar to FNV-1a, but eight bytes at a time), for quickly
+// identifying world content.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __HASH_H__
+#define __HASH_H__
+
+#include <string>
+#include <cstring>
+#include <glib.h>
+
+namespace Enigma
+{
+	class Hash
+	{
+		public:
+			// Public declarations.
+
+			static const guint64 OFFSET = 14695981039346656037ULL;  // FNV offset.
+			static const guint64 PRIME  = 1099511628211ULL;         // FNV prime.
+
+			// Public methods.
+
+			Hash() : m_value(OFFSET) {}
+
+			//-----------------------------------------------------------------
+			// This method adds bytes to the hash, eight bytes at a time.
+			//-----------------------------------------------------------------
+			// data: Bytes to be added.
+			// size: Number of bytes.
+			//-----------------------------------------------------------------
+
+			void add(const void* data, gsize size)
+			{
+				const guchar* byte = (const guchar*)data;
+				guint64 value;
+
+				for (; size >= 8; size -= 8, byte += 8)
+				{
+					memcpy(&value, byte, 8);
+					add(value);
+				}
+
+				for (; size > 0; -- size, ++ byte)
+				{
+					m_value ^= *byte;
+					m_value *= PRIME;
+				}
+			}
+
+			//--------------------------------------------------------------
+			// This method adds a string to the hash.  The length is added
+			// first, so that adjacent strings cannot run together.
+			//--------------------------------------------------------------
+			// string: String to be added.
+			//--------------------------------------------------------------
+
+			void add(const std::string& string)
+			{
+				add((guint64)string.size());
+				add(string.data(), string.size());
+			}
+
+			//---------------------------------------------------------------
+			// This method adds a value to the hash.  The high bits are
+			// folded down, so they affect all bits of later values.
+			//---------------------------------------------------------------
+			// value: Value to be added.
+			//---------------------------------------------------------------
+
+			void add(guint64 value)
+			{
+				m_value ^= value;
+				m_value *= PRIME;
+				m_value ^= (m_value >> 29);
+			}
+
+			//-------------------------------------------------------------------
+			// This method returns the hash value.  The bits are mixed further,
+			// so that hashes may be combined by adding them together.
+			//-------------------------------------------------------------------
+			// RETURN: Hash value.
+			//-------------------------------------------------------------------
+
+			guint64 get() const
+			{
+				guint64 value = m_value;
+
+				value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+				value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+				return value ^ (value >> 31);
+			}
+
+		private:
+			// Private data.
+
+			guint64 m_value;   // Hash value being computed.
+	};
+}
+
+#endif // __HASH_H__
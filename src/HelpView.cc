@@ -41,6 +41,7 @@ F5:  Map controllers viewer.\n\
 F6:  Map control editor.\n\
 F7:  Map description editor.\n\
 F8:  Help.\n\
+F9:  Show or hide a second Level viewer pane (starts one level above).\n\
 \n\
 LEVEL VIEWER KEYS\n\
 Cursor Left/Right: Move cursor West/East.\n\
@@ -52,6 +53,11 @@ Shift or Escape: Unmark volume.\n\
 Control X: Cut volume.\n\
 Control C: Copy volume.\n\
 Control V: Paste volume.\n\
+Control P: Show or hide drawing times of Level viewer frames.\n\
+Plus: Zoom in.\n\
+Minus: Zoom out (small rooms are drawn as blocks of colour).\n\
+Click on level overview (right of Level viewer): Move cursor to room.\n\
+Click on a Level viewer pane: Move keyboard to that pane.\n\
 \n\
 CONTROLLER VIEWER KEYS\n\
 Delete: Delete selected controller (requires confirmation)\n\
@@ -72,7 +78,11 @@ Filter Level Viewer object: f 'code'\n\
 Add Map Controller: c 'name'\n\
 Load game map: l 'filename'\n\
 Save game map: s 'filename'\n\
+Save gzip compressed game map: s 'filename.gz'\n\
+Save level-chunked game map (editor only): s 'filename.ewci'\n\
+Save JSON Lines text game map (editor only): s 'filename.jsonl'\n\
 Reload game map: l\n\
+Cancel loading game map: Escape\n\
 Resave game map: s\n\
 Begin new named game map: n 'filename'\n\
 Begin new unnamed game map: n\n\
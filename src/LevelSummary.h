@@ -0,0 +1,47 @@
+// "World in the Wine Cellar" world creator for "Enigma in the Wine Cellar".
+// Copyright (C) 2021 Chris Sterne <chris_sterne@hotmail.com>
+//
+// This file contains the LevelSummary class header.  The LevelSummary class
+// holds the colour of every occupied room on one level of the world.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __LEVELSUMMARY_H__
+#define __LEVELSUMMARY_H__
+
+#include <map>
+#include <utility>
+#include <glib.h>
+#include "Volume.h"
+
+namespace Enigma
+{
+	class LevelSummary
+	{
+		public:
+			// Public declarations.  Rooms are keyed by (North, East), so the
+			// rooms of one row follow each other from west to east.
+
+			typedef std::pair<unsigned short, unsigned short> Room;
+
+			// Public data.  Only rooms with a colour are kept, so a level
+			// spanning the whole world costs no more than its objects.  The
+			// drawing order of a room's colour is kept in the top byte.
+
+			std::map<Room, guint32> m_rooms;  // Colours of occupied rooms.
+			Enigma::Volume m_volume;          // Rooms between outermost objects.
+	};
+}
+
+#endif // __LEVELSUMMARY_H__
@@ -17,6 +17,11 @@
 // You should have received a copy of the GNU General Public License along
 // with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <thread>
 #include <glibmm/i18n.h>
 #include "LevelView.h"
 #include "World.h"
@@ -29,6 +34,24 @@
 #define BACKGROUND_G 0
 #define BACKGROUND_B 0
 
+#define PROFILEFRAMES 120   // Frame times shown by profile graph.
+#define PROFILEMARGIN 6     // Pixel margin of profile overlay.
+#define PROFILEGRAPH 40     // Pixel height of graph (1/30 second).
+
+typedef std::chrono::steady_clock Clock;
+
+//------------------------------------------------------------------
+// This private function returns the seconds since a moment of time.
+//------------------------------------------------------------------
+// start:  Moment of time.
+// RETURN: Seconds since moment.
+//------------------------------------------------------------------
+
+double seconds_since(const Clock::time_point& start)
+{
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
 //-------------------------
 // This is the constructor.
 //-------------------------
@@ -38,7 +61,7 @@ Enigma::LevelView::LevelView()
   set_has_window(true);
   set_hexpand(true);
   set_vexpand(true);
-  add_events(Gdk::KEY_PRESS_MASK);
+  add_events(Gdk::KEY_PRESS_MASK | Gdk::BUTTON_PRESS_MASK);
   set_can_focus(true);
 
   m_cursor.m_east  = 0;
@@ -52,6 +75,13 @@ Enigma::LevelView::LevelView()
   m_mark.m_ENA = m_cursor;
   
   m_filter = Enigma::Object::ID::NONE;
+  m_edit_buffer = std::make_shared<std::list<Enigma::Object>>();
+  m_layer_valid = false;
+  m_layer_size = 0;
+  m_layer_scale = 1;
+  m_summary_valid = false;
+  m_position_tick = 0;
+  m_profile = false;
 }
 
 //---------------------------------------------------
@@ -162,7 +192,18 @@ void align_range(unsigned short number,
 void Enigma::LevelView::on_size_allocate(Gtk::Allocation& allocation)
 {	
 	Gtk::Widget::on_size_allocate(allocation);
-	
+	set_view_size();
+}
+
+//------------------------------------------------------------------
+// This private method sets the number of visible rows and columns
+// from the widget size and room size, keeping the cursor in view.
+//------------------------------------------------------------------
+
+void Enigma::LevelView::set_view_size()
+{
+	Gtk::Allocation allocation = get_allocation();
+
 	unsigned short width  =
 		allocation.get_width() / m_tiles.get_tile_size();
 	
@@ -182,6 +223,20 @@ void Enigma::LevelView::on_size_allocate(Gtk::Allocation& allocation)
 	align_range(m_cursor.m_north, m_view.m_WSB.m_north, m_view.m_ENA.m_north);
 }
 
+//-------------------------------------------------------------------
+// This private method sets the zoom level.  The view keeps the
+// cursor visible, and is drawn again with the new room size.
+//-------------------------------------------------------------------
+// zoom: Zoom level.
+//-------------------------------------------------------------------
+
+void Enigma::LevelView::set_zoom(guint zoom)
+{
+	m_tiles.set_zoom(zoom);
+	set_view_size();
+	queue_draw();
+}
+
 //*-------------------------------------------------------------*
 //* This method is called when the widget is about to be shown. *
 //*-------------------------------------------------------------*
@@ -191,34 +246,662 @@ void Enigma::LevelView::on_map()
 	// Pass the method to the base class.
 
 	Gtk::DrawingArea::on_map();
+
+	// Other views may have changed the world while this view was hidden.
+
+	m_layer_valid = false;
 	
 	// Update cursor location information.
 	
 	do_position();
 }
 
-//----------------------------------
-// Method to draw PlayerView widget.
-//----------------------------------
+//---------------------------------------------------------
+// This private function returns TRUE if two world volumes
+// are the same.
+//---------------------------------------------------------
+// first:  First volume.
+// second: Second volume.
+// RETURN: TRUE if the volumes are the same.
+//---------------------------------------------------------
+
+bool equal_volumes(const Enigma::Volume& first, const Enigma::Volume& second)
+{
+	return (first.m_WSB.m_above == second.m_WSB.m_above)
+	    && (first.m_WSB.m_north == second.m_WSB.m_north)
+	    && (first.m_WSB.m_east == second.m_WSB.m_east)
+	    && (first.m_ENA.m_above == second.m_ENA.m_above)
+	    && (first.m_ENA.m_north == second.m_ENA.m_north)
+	    && (first.m_ENA.m_east == second.m_ENA.m_east);
+}
+
+//-----------------------------------------------------------------
+// This private method draws the objects in one visible room.
+//-----------------------------------------------------------------
 // context: Cairo drawing context.
-//----------------------------------
+// room:    Position of room.
+//-----------------------------------------------------------------
+
+void Enigma::LevelView::draw_room(const Cairo::RefPtr<Cairo::Context>& context,
+                                  Enigma::Position& room)
+{
+	Gtk::Allocation allocation = get_allocation();
+
+	unsigned short row    = room.m_north - m_view.m_WSB.m_north;
+	unsigned short column = room.m_east - m_view.m_WSB.m_east;
+
+	if (!m_tiles.get_detailed())
+	{
+		// The room is too small for image tiles, so draw its colour from
+		// the level summary.
+
+		std::map<Enigma::LevelSummary::Room, guint32>::const_iterator found =
+			m_summary.m_rooms.find(Enigma::LevelSummary::Room(room.m_north, room.m_east));
+
+		if (found != m_summary.m_rooms.end())
+		{
+			guint32 value = found->second;
+			int size = m_tiles.get_tile_size();
+
+			context->set_source_rgb(((value >> 16) & 0xff) / 255.0,
+			                        ((value >> 8) & 0xff) / 255.0,
+			                        (value & 0xff) / 255.0);
+
+			context->rectangle(column * size,
+			                   allocation.get_height() - size - (row * size),
+			                   size,
+			                   size);
+			context->fill();
+		}
+
+		return;
+	}
+
+	std::vector<Enigma::Object*> objects;
+	Clock::time_point start = Clock::now();
+
+	gather_room(room, objects);
+	m_stats.m_query += seconds_since(start);
+
+	start = Clock::now();
+	draw_objects(context, allocation, column, row, objects);
+	m_stats.m_tiles += seconds_since(start);
+}
+
+//---------------------------------------------------------------------
+// This private method gets the objects in a room to be drawn, in the
+// order they are drawn: environment objects first, then floor objects,
+// then all objects above the floor.  Objects hidden by the viewing
+// filter are left out.
+//---------------------------------------------------------------------
+// room:    Position of room.
+// objects: Vector to receive the objects.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::gather_room(Enigma::Position& room,
+                                    std::vector<Enigma::Object*>& objects)
+{
+	std::list<std::list<Enigma::Object>::iterator> buffer;
+	std::list<std::list<Enigma::Object>::iterator>::iterator object;
+
+	// Read all objects in the room.
+
+	m_world->m_objects.read(room, buffer);
+	m_world->m_items.read(room, buffer);
+	m_world->m_players.read(room, buffer);
+	m_world->m_teleporters.read(room, buffer);
+	++ m_stats.m_rooms;
+
+	// Gather all environment objects first.
+
+	for (object = buffer.begin();
+	     object != buffer.end();
+	     ++ object)
+	{
+		if  (((*(*object)).m_id == Enigma::Object::ID::OUTDOOR)
+			|| ((*(*object)).m_id == Enigma::Object::ID::INDOOR))
+		{
+			if  ((m_filter == Enigma::Object::ID::NONE)
+				|| (m_filter == (*(*object)).m_id))
+			{
+				objects.push_back(&(*(*object)));
+				++ m_stats.m_environment;
+			}
+
+			// Erase environment object so it will not be gathered again.
+
+			object = buffer.erase(object);
+		}
+	}
+
+	// Gather all floor objects next.
+
+	for (object = buffer.begin();
+	     object != buffer.end();
+	     ++ object)
+	{
+		if ((((*(*object)).m_id == Enigma::Object::ID::BLOCKWALL)
+			|| ((*(*object)).m_id == Enigma::Object::ID::STONEWALL)
+			|| ((*(*object)).m_id == Enigma::Object::ID::WOODWALL)
+			|| ((*(*object)).m_id == Enigma::Object::ID::EARTHWALL))
+			&& ((*(*object)).m_surface == Enigma::Object::Direction::BELOW))
+		{
+			if  ((m_filter == Enigma::Object::ID::NONE)
+			  || (m_filter == (*(*object)).m_id))
+			{
+				objects.push_back(&(*(*object)));
+				++ m_stats.m_floor;
+			}
+
+			// Erase floor object so it will not be gathered again.
+
+			object = buffer.erase(object);
+		}
+	}
+
+	// Gather all objects above the floor.
+
+	for (object = buffer.begin(); object != buffer.end(); ++ object)
+	{
+		if  ((m_filter == Enigma::Object::ID::NONE)
+		  || ( m_filter == (*(*object)).m_id))
+		{
+			objects.push_back(&(*(*object)));
+			++ m_stats.m_objects;
+		}
+	}
+}
+
+//---------------------------------------------------------------------
+// This private method draws gathered objects in one visible room as a
+// single stack of image tiles.  It uses only the image tiles, so bands
+// of rooms may be drawn by several threads at once.
+//---------------------------------------------------------------------
+// context:    Cairo drawing context.
+// allocation: Pixel boundary of view.
+// column:     Visible column of room.
+// row:        Visible row of room.
+// objects:    Objects to draw, in drawing order.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::draw_objects(const Cairo::RefPtr<Cairo::Context>& context,
+                                     Gtk::Allocation allocation,
+                                     unsigned short column,
+                                     unsigned short row,
+                                     const std::vector<Enigma::Object*>& objects)
+{
+	m_tiles.draw_stack(context, allocation, column, row, objects);
+}
+
+//---------------------------------------------------------------------
+// This private method creates a surface for the layer.  It is made
+// similar to the widget's window, with the same pixel format and
+// scale, so copying it to the window is a straight copy of pixels
+// without conversion or scaling.
+//---------------------------------------------------------------------
+// RETURN: Layer surface.
+//---------------------------------------------------------------------
+
+Cairo::RefPtr<Cairo::ImageSurface> Enigma::LevelView::create_layer()
+{
+	Gtk::Allocation allocation = get_allocation();
+	Glib::RefPtr<Gdk::Window> window = get_window();
+
+	m_layer_scale = get_scale_factor();
+
+	if (window)
+	{
+		return Cairo::RefPtr<Cairo::ImageSurface>::cast_static(
+			window->create_similar_image_surface(
+				Cairo::FORMAT_RGB24,
+				allocation.get_width() * m_layer_scale,
+				allocation.get_height() * m_layer_scale,
+				m_layer_scale));
+	}
+
+	m_layer_scale = 1;
+
+	return Cairo::ImageSurface::create(Cairo::FORMAT_RGB24,
+	                                   allocation.get_width(),
+	                                   allocation.get_height());
+}
+
+//---------------------------------------------------------------------
+// This private method returns TRUE if a layer surface matches the
+// widget's size and scale.  After the display scale changes, the
+// layer is created and drawn again.
+//---------------------------------------------------------------------
+// layer:  Layer surface.
+// RETURN: TRUE if the surface matches the widget.
+//---------------------------------------------------------------------
+
+bool Enigma::LevelView::layer_fits(const Cairo::RefPtr<Cairo::ImageSurface>& layer)
+{
+	Gtk::Allocation allocation = get_allocation();
+	int scale = get_window() ? get_scale_factor() : 1;
+
+	return layer
+	    && (m_layer_scale == scale)
+	    && (layer->get_width() == allocation.get_width() * scale)
+	    && (layer->get_height() == allocation.get_height() * scale);
+}
+
+//---------------------------------------------------------------------
+// This private method draws the objects of all visible rooms into the
+// layer surface, which is copied to the widget when it is drawn.  The
+// layer is only drawn again when the world or the view changes.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::draw_layer()
+{
+	if (!layer_fits(m_layer))
+		m_layer = create_layer();
+
+	Cairo::RefPtr<Cairo::Context> context = Cairo::Context::create(m_layer);
 
-bool Enigma::LevelView::on_draw(const Cairo::RefPtr<Cairo::Context>& context)
-{	
 	// Draw the background colour.
 
 	context->set_source_rgb(BACKGROUND_R, BACKGROUND_G, BACKGROUND_B);
 	context->paint();
 
-	Gtk::Allocation allocation = get_allocation();
 	Enigma::Position room;
+	room.m_above = m_cursor.m_above;
+
+	++ m_stats.m_layer_redraws;
+	Clock::time_point start = Clock::now();
+
+	// Ensure the level's structural objects have been loaded.
+
+	m_world->load_level(room.m_above);
+
+	if (m_tiles.get_detailed())
+	{
+		// Gather the objects of every visible room first.  The object lists
+		// keep their place between searches, so they are only searched by
+		// this thread.
+
+		int columns = m_view.m_ENA.m_east - m_view.m_WSB.m_east + 1;
+		int rows    = m_view.m_ENA.m_north - m_view.m_WSB.m_north + 1;
+
+		std::vector<std::vector<Enigma::Object*>> rooms(columns * rows);
+
+		for (int row = 0; row < rows; ++ row)
+		{
+			room.m_north = m_view.m_WSB.m_north + row;
+
+			for (int column = 0; column < columns; ++ column)
+			{
+				room.m_east = m_view.m_WSB.m_east + column;
+				gather_room(room, rooms[(row * columns) + column]);
+			}
+		}
+
+		m_stats.m_query += seconds_since(start);
+		start = Clock::now();
+
+		draw_bands(context, rooms, columns, rows);
+	}
+	else
+	{
+		// Rooms are too small for image tiles.  Draw each as a block of
+		// colour from the level summary.
+
+		m_stats.m_query += seconds_since(start);
+		start = Clock::now();
+
+		draw_summary();
+	}
+
+	m_stats.m_tiles += seconds_since(start);
+
+	m_layer_view  = m_view;
+	m_layer_size  = m_tiles.get_tile_size();
+	m_layer_valid = true;
+}
+
+//---------------------------------------------------------------------
+// This private method draws gathered rooms into the layer.  The view
+// is divided into horizontal bands of rows, which worker threads draw
+// into surfaces of their own.  The bands are then copied into the
+// layer by this thread.
+//---------------------------------------------------------------------
+// context: Cairo context of layer.
+// rooms:   Objects of each visible room, by row then column.
+// columns: Number of visible columns.
+// rows:    Number of visible rows.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::draw_bands(
+	const Cairo::RefPtr<Cairo::Context>& context,
+	const std::vector<std::vector<Enigma::Object*>>& rooms,
+	int columns,
+	int rows)
+{
+	Gtk::Allocation allocation = get_allocation();
+
+	int size   = m_tiles.get_tile_size();
+	int height = allocation.get_height();
+	int scale  = m_layer_scale;
+
+	// Use about two bands for each processor core, so threads finishing
+	// early can take another.
+
+	guint jobs = std::max(std::thread::hardware_concurrency(), 1u);
+	int band_rows = std::max(1, (rows + (int)(jobs * 2) - 1) / (int)(jobs * 2));
+	int bands = (rows + band_rows - 1) / band_rows;
+
+	jobs = std::min(jobs, (guint)bands);
+
+	std::vector<Cairo::RefPtr<Cairo::ImageSurface>> surfaces(bands);
+	std::vector<int> tops(bands);
+	std::vector<std::thread> workers;
+	std::atomic<int> next(0);
+
+	for (guint job = 0; job < jobs; ++ job)
+	{
+		workers.emplace_back([&]()
+		{
+			int band;
+
+			while ((band = next ++) < bands)
+			{
+				// Rows are numbered upwards from the bottom of the view.  The
+				// top row may be only partly visible.
+
+				int first  = band * band_rows;
+				int last   = std::min(first + band_rows, rows);
+				int top    = std::max(height - (last * size), 0);
+				int bottom = height - (first * size);
+
+				if (bottom <= top)
+					continue;
+
+				Cairo::RefPtr<Cairo::ImageSurface> surface =
+					Cairo::ImageSurface::create(Cairo::FORMAT_RGB24,
+					                            allocation.get_width() * scale,
+					                            (bottom - top) * scale);
+
+				Cairo::RefPtr<Cairo::Context> band_context =
+					Cairo::Context::create(surface);
+
+				band_context->scale(scale, scale);
+				band_context->translate(0, -top);
+				band_context->set_source_rgb(BACKGROUND_R, BACKGROUND_G, BACKGROUND_B);
+				band_context->paint();
+
+				for (int row = first; row < last; ++ row)
+				{
+					for (int column = 0; column < columns; ++ column)
+					{
+						draw_objects(band_context,
+						             allocation,
+						             column,
+						             row,
+						             rooms[(row * columns) + column]);
+					}
+				}
+
+				surfaces[band] = surface;
+				tops[band] = top;
+			}
+		});
+	}
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	// Copy the bands into the layer, pixel for pixel.
+
+	context->save();
+	context->scale(1.0 / scale, 1.0 / scale);
+
+	for (int band = 0; band < bands; ++ band)
+	{
+		if (surfaces[band])
+		{
+			context->set_source(surfaces[band], 0, tops[band] * scale);
+			context->paint();
+		}
+	}
+
+	context->restore();
+}
+
+//---------------------------------------------------------------------
+// This private method combines an object's colour into the summary
+// colour of its room.  Objects drawn later in a room (environment,
+// then floor, then all others) take the place of those drawn earlier.
+// The drawing order is kept in the top byte of the summary value.
+//---------------------------------------------------------------------
+// object: Map object.
+// value:  Summary value of room.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::summarize(const Enigma::Object& object, guint32& value)
+{
+	if ((m_filter != Enigma::Object::ID::NONE) && (m_filter != object.m_id))
+		return;
+
+	guint32 order;
+
+	if ((object.m_id == Enigma::Object::ID::OUTDOOR)
+	    || (object.m_id == Enigma::Object::ID::INDOOR))
+	{
+		order = 1;
+	}
+	else if (((object.m_id == Enigma::Object::ID::BLOCKWALL)
+	          || (object.m_id == Enigma::Object::ID::STONEWALL)
+	          || (object.m_id == Enigma::Object::ID::WOODWALL)
+	          || (object.m_id == Enigma::Object::ID::EARTHWALL))
+	         && (object.m_surface == Enigma::Object::Direction::BELOW))
+	{
+		order = 2;
+	}
+	else
+		order = 3;
+
+	if (order >= (value >> 24))
+		value = (order << 24) | m_tiles.get_colour(object);
+}
+
+//---------------------------------------------------------------------
+// This private method finds the colour of every room on the cursor's
+// level, for drawing the level when rooms are too small for image
+// tiles.  Only occupied rooms are kept, along with the rooms between
+// the level's outermost objects.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::build_summary()
+{
+	Enigma::ObjectList* lists[] = {&m_world->m_objects,
+	                       &m_world->m_items,
+	                       &m_world->m_players,
+	                       &m_world->m_teleporters};
+
+	unsigned short level = m_cursor.m_above;
+
+	m_world->load_level(level);
+
+	// Read the level's objects from the sorted lists.
+
+	Enigma::Volume volume;
 	std::list<std::list<Enigma::Object>::iterator> buffer;
-	std::list<std::list<Enigma::Object>::iterator>::iterator object;
-	bool drawn;
 
-	unsigned short row;
-	unsigned short column; 
+	volume.m_WSB.m_above = level;
+	volume.m_WSB.m_north = Enigma::Position::MINIMUM;
+	volume.m_WSB.m_east  = Enigma::Position::MINIMUM;
+	volume.m_ENA.m_above = level;
+	volume.m_ENA.m_north = Enigma::Position::MAXIMUM;
+	volume.m_ENA.m_east  = Enigma::Position::MAXIMUM;
+
+	for (Enigma::ObjectList* list : lists)
+		list->read(volume, buffer);
+
+	m_summary.m_rooms.clear();
+	m_summary.m_volume.m_WSB.m_above = level;
+	m_summary.m_volume.m_ENA.m_above = level;
+	m_summary.m_volume.m_WSB.m_north = Enigma::Position::MAXIMUM;
+	m_summary.m_volume.m_WSB.m_east  = Enigma::Position::MAXIMUM;
+	m_summary.m_volume.m_ENA.m_north = Enigma::Position::MINIMUM;
+	m_summary.m_volume.m_ENA.m_east  = Enigma::Position::MINIMUM;
+	m_summary_valid = true;
+
+	// Find the rooms between the level's outermost objects, and the colour
+	// of each occupied room.
+
+	for (std::list<Enigma::Object>::iterator object : buffer)
+	{
+		Enigma::Position& position = object->m_position;
+
+		m_summary.m_volume.m_WSB.m_north =
+			std::min(m_summary.m_volume.m_WSB.m_north, position.m_north);
+		m_summary.m_volume.m_WSB.m_east =
+			std::min(m_summary.m_volume.m_WSB.m_east, position.m_east);
+		m_summary.m_volume.m_ENA.m_north =
+			std::max(m_summary.m_volume.m_ENA.m_north, position.m_north);
+		m_summary.m_volume.m_ENA.m_east =
+			std::max(m_summary.m_volume.m_ENA.m_east, position.m_east);
+
+		Enigma::LevelSummary::Room room(position.m_north, position.m_east);
+		guint32 value = 0;
+
+		std::map<Enigma::LevelSummary::Room, guint32>::iterator found =
+			m_summary.m_rooms.find(room);
+
+		if (found != m_summary.m_rooms.end())
+			value = found->second;
+
+		summarize(*object, value);
+
+		if (value)
+			m_summary.m_rooms[room] = value;
+	}
+
+	m_signal_summary.emit(m_summary, std::list<Enigma::Position>());
+}
+
+//---------------------------------------------------------------------
+// This private method draws the visible rooms of the level summary
+// into the layer.  Blocks of only a few pixels are written directly
+// into the layer's pixels, which is much faster than filling each
+// with Cairo.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::draw_summary()
+{
+	if (m_summary.m_rooms.empty())
+		return;
+
+	// The layer's pixels may be smaller than the view's units on a
+	// high-resolution display.
+
+	int size   = m_tiles.get_tile_size() * m_layer_scale;
+	int width  = m_layer->get_width();
+	int height = m_layer->get_height();
+
+	m_layer->flush();
+
+	unsigned char* data = m_layer->get_data();
+	int stride = m_layer->get_stride();
+
+	// Only the occupied rooms of each visible row are visited, found in
+	// order from the row's first visible room.
+
+	for (int room_north = m_view.m_WSB.m_north;
+	     room_north <= m_view.m_ENA.m_north;
+	     ++ room_north)
+	{
+		std::map<Enigma::LevelSummary::Room, guint32>::const_iterator room =
+			m_summary.m_rooms.lower_bound(
+				Enigma::LevelSummary::Room(room_north, m_view.m_WSB.m_east));
+
+		int y = height - size - ((room_north - m_view.m_WSB.m_north) * size);
+
+		for (;
+		     (room != m_summary.m_rooms.end())
+		     && (room->first.first == room_north)
+		     && (room->first.second <= m_view.m_ENA.m_east);
+		     ++ room)
+		{
+			int x = (room->first.second - m_view.m_WSB.m_east) * size;
+
+			// Rooms along the top and right edges may be partly visible.
+
+			for (int pixel_y = std::max(y, 0);
+			     pixel_y < std::min(y + size, height);
+			     ++ pixel_y)
+			{
+				guint32* pixel = (guint32*)(data + (pixel_y * stride)) + x;
+
+				for (int pixel_x = x;
+				     pixel_x < std::min(x + size, width);
+				     ++ pixel_x, ++ pixel)
+				{
+					*pixel = room->second & 0xffffff;
+				}
+			}
+		}
+	}
+
+	m_layer->mark_dirty();
+}
+
+//---------------------------------------------------------------------
+// This private method updates the layer after the view has scrolled
+// on the same level.  The rooms still visible are copied to their new
+// place, and only the rooms scrolled into view are drawn.  The top row
+// and right column of the previous view are drawn again, since they
+// may have been only partly visible.
+//---------------------------------------------------------------------
+// RETURN: TRUE if the layer was scrolled, or FALSE if it must be drawn
+//         completely.
+//---------------------------------------------------------------------
+
+bool Enigma::LevelView::scroll_layer()
+{
+	Enigma::Volume& previous = m_layer_view;
+	int size = m_tiles.get_tile_size();
+
+	// The previous and new views must be of the cursor's level, and must
+	// overlap by more than their edges.
+
+	if ((previous.m_WSB.m_above != m_cursor.m_above)
+	    || (m_view.m_WSB.m_above != m_cursor.m_above)
+	    || ((previous.m_ENA.m_north - previous.m_WSB.m_north)
+	        != (m_view.m_ENA.m_north - m_view.m_WSB.m_north))
+	    || ((previous.m_ENA.m_east - previous.m_WSB.m_east)
+	        != (m_view.m_ENA.m_east - m_view.m_WSB.m_east))
+	    || (m_view.m_WSB.m_north >= previous.m_ENA.m_north)
+	    || (previous.m_WSB.m_north >= m_view.m_ENA.m_north)
+	    || (m_view.m_WSB.m_east >= previous.m_ENA.m_east)
+	    || (previous.m_WSB.m_east >= m_view.m_ENA.m_east))
+	{
+		return false;
+	}
+
+	// Copy the previous layer to a second surface, shifted by the scrolled
+	// distance.  Rooms move left as the view moves East, and down as it
+	// moves North.
+
+	if (!layer_fits(m_layer_back))
+		m_layer_back = create_layer();
+
+	Cairo::RefPtr<Cairo::Context> context = Cairo::Context::create(m_layer_back);
+
+	context->set_source_rgb(BACKGROUND_R, BACKGROUND_G, BACKGROUND_B);
+	context->paint();
+
+	context->set_source(m_layer,
+	                    (previous.m_WSB.m_east - m_view.m_WSB.m_east) * size,
+	                    (m_view.m_WSB.m_north - previous.m_WSB.m_north) * size);
+	context->paint();
 
+	std::swap(m_layer, m_layer_back);
+
+	// Draw the rooms that were not fully visible in the previous view.
+
+	int height = get_allocated_height();
+	Enigma::Position room;
 	room.m_above = m_cursor.m_above;
 
 	for (room.m_north = m_view.m_WSB.m_north;
@@ -229,105 +912,110 @@ bool Enigma::LevelView::on_draw(const Cairo::RefPtr<Cairo::Context>& context)
 		     room.m_east <= m_view.m_ENA.m_east;
 		     ++ room.m_east)
 		{
-			row    = room.m_north - m_view.m_WSB.m_north;
-			column = room.m_east - m_view.m_WSB.m_east;
+			if ((room.m_north >= previous.m_WSB.m_north)
+			    && (room.m_north < previous.m_ENA.m_north)
+			    && (room.m_east >= previous.m_WSB.m_east)
+			    && (room.m_east < previous.m_ENA.m_east))
+			{
+				continue;
+			}
 
-			// Read all objects in the room.
+			int column = room.m_east - m_view.m_WSB.m_east;
+			int row    = room.m_north - m_view.m_WSB.m_north;
 
-			buffer.resize(0);
-			m_world->m_objects.read(room, buffer);
-			m_world->m_items.read(room, buffer);
-			m_world->m_players.read(room, buffer);
-			m_world->m_teleporters.read(room, buffer);
+			context->set_source_rgb(BACKGROUND_R, BACKGROUND_G, BACKGROUND_B);
+			context->rectangle(column * size,
+			                   height - size - (row * size),
+			                   size,
+			                   size);
+			context->fill();
 
-			// Draw all environment objects first.
+			draw_room(context, room);
+		}
+	}
 
-			for (object = buffer.begin();
-			     object != buffer.end();
-			     ++ object)
-			{
-				if  (((*(*object)).m_id == Enigma::Object::ID::OUTDOOR)
-					|| ((*(*object)).m_id == Enigma::Object::ID::INDOOR))
-				{
-					if  ((m_filter == Enigma::Object::ID::NONE)
-						|| (m_filter == (*(*object)).m_id))
-					{
-						drawn = m_tiles.draw_object(context,
-						                            allocation,
-						                            column,
-						                            row,
-						                            *(*object));					
-						if (!drawn)
-							m_tiles.draw_generic(context, allocation, column, row);
-					}
+	++ m_stats.m_layer_scrolls;
+	m_layer_view = m_view;
+	return true;
+}
+
+//----------------------------------
+// Method to draw PlayerView widget.
+//----------------------------------
+// context: Cairo drawing context.
+//----------------------------------
+
+bool Enigma::LevelView::on_draw(const Cairo::RefPtr<Cairo::Context>& context)
+{	
+	// Copy the objects from the layer, drawing them again only if the world
+	// or view has changed.  The marker, arrival and cursor tiles are drawn
+	// over them.
+
+	Gtk::Allocation allocation = get_allocation();
+	bool moved = !m_layer_valid || !equal_volumes(m_layer_view, m_view);
+	Clock::time_point start = Clock::now();
+
+	// The level summary is found again only when the world, the filter
+	// or the level has changed.  It is shown by the minimap, and used to
+	// draw rooms too small for image tiles.
 
-					// Erase environment object so it will not drawn again.
+	if (!m_summary_valid
+	    || (m_summary.m_volume.m_WSB.m_above != m_cursor.m_above))
+	{
+		Clock::time_point summary_start = Clock::now();
+
+		build_summary();
+		m_stats.m_query += seconds_since(summary_start);
+	}
+
+	if (!m_layer_valid
+	    || !layer_fits(m_layer)
+	    || (m_layer_size != m_tiles.get_tile_size()))
+	{
+		draw_layer();
+	}
+	else if (!equal_volumes(m_layer_view, m_view))
+	{
+		// The view has scrolled.  Reuse the rooms still visible if possible.
+
+		if (!scroll_layer())
+			draw_layer();
+	}
 
-					object = buffer.erase(object);
-				}
-			}
+	if (moved)
+		m_signal_view.emit(m_view);
 
-			// Draw all floor objects first.
+	context->set_source(m_layer, 0, 0);
+	context->paint();
 
-			for (object = buffer.begin();
-			     object != buffer.end();
-			     ++ object)
-			{
-				if ((((*(*object)).m_id == Enigma::Object::ID::BLOCKWALL)
-					|| ((*(*object)).m_id == Enigma::Object::ID::STONEWALL)
-					|| ((*(*object)).m_id == Enigma::Object::ID::WOODWALL)
-					|| ((*(*object)).m_id == Enigma::Object::ID::EARTHWALL))
-					&& ((*(*object)).m_surface == Enigma::Object::Direction::BELOW))
-				{
-					if  ((m_filter == Enigma::Object::ID::NONE)
-					  || (m_filter == (*(*object)).m_id))
-					{
-						drawn = m_tiles.draw_object(context,
-						                            allocation,
-						                            column,
-						                            row,
-						                            *(*object));
-						if (!drawn)
-							m_tiles.draw_generic(context, allocation, column, row);
-					}
+	Clock::time_point overlay_start = Clock::now();
+	Enigma::Position room;
 
-					// Erase floor object so it will not drawn again.
+	unsigned short row;
+	unsigned short column; 
 
-					object = buffer.erase(object);
-				}
-			}
+	room.m_above = m_cursor.m_above;
 
-			// Draw all objects above the floor.
+	// Draw a marker in each visible room on the level that falls within the
+	// marked area, if the marked area is greater than one room in volume.
 
-			for (object = buffer.begin(); object != buffer.end(); ++ object)
+	if (((m_mark.m_ENA.m_above != m_mark.m_WSB.m_above)
+	  || (m_mark.m_ENA.m_north != m_mark.m_WSB.m_north)
+	  || (m_mark.m_ENA.m_east != m_mark.m_WSB.m_east))
+	  && (room.m_above >= m_mark.m_WSB.m_above)
+	  && (room.m_above <= m_mark.m_ENA.m_above))
+	{
+		for (room.m_north = std::max(m_view.m_WSB.m_north, m_mark.m_WSB.m_north);
+		     room.m_north <= std::min(m_view.m_ENA.m_north, m_mark.m_ENA.m_north);
+		     ++ room.m_north )
+		{
+			for (room.m_east = std::max(m_view.m_WSB.m_east, m_mark.m_WSB.m_east);
+			     room.m_east <= std::min(m_view.m_ENA.m_east, m_mark.m_ENA.m_east);
+			     ++ room.m_east)
 			{
-				if  ((m_filter == Enigma::Object::ID::NONE)
-				  || ( m_filter == (*(*object)).m_id))
-				{
-					drawn = m_tiles.draw_object(context,
-					                            allocation,
-					                            column,
-					                            row,
-					                            *(*object));                       
-					
-					if (!drawn)
-						m_tiles.draw_generic(context, allocation, column, row);
-				}
-			}
+				row    = room.m_north - m_view.m_WSB.m_north;
+				column = room.m_east - m_view.m_WSB.m_east;
 
-			// Draw a marker if the current room location falls within the marked
-			// area and the marked area is greater than one room in volume.
-
-			if (((m_mark.m_ENA.m_above != m_mark.m_WSB.m_above)
-			  || (m_mark.m_ENA.m_north != m_mark.m_WSB.m_north)
-			  || (m_mark.m_ENA.m_east != m_mark.m_WSB.m_east))
-			  && (room.m_above >= m_mark.m_WSB.m_above)
-			  && (room.m_above <= m_mark.m_ENA.m_above)
-			  && (room.m_north >= m_mark.m_WSB.m_north)
-			  && (room.m_north <= m_mark.m_ENA.m_north)
-			  && (room.m_east >= m_mark.m_WSB.m_east)
-			  && (room.m_east <= m_mark.m_ENA.m_east))
-			{
 				m_tiles.draw_marker(context, allocation, column, row);
 			}
 		}
@@ -365,7 +1053,7 @@ bool Enigma::LevelView::on_draw(const Cairo::RefPtr<Cairo::Context>& context)
 		  && (east_arrival <= m_view.m_ENA.m_east)
 		  && (north_arrival >= m_view.m_WSB.m_north)
 		  && (north_arrival <= m_view.m_ENA.m_north)
-		  && (above_arrival == room.m_above))
+		  && (above_arrival == m_cursor.m_above))
 		{
 			column = east_arrival - m_view.m_WSB.m_east;
 			row    = north_arrival - m_view.m_WSB.m_north;
@@ -381,11 +1069,147 @@ bool Enigma::LevelView::on_draw(const Cairo::RefPtr<Cairo::Context>& context)
 
 	m_tiles.draw_cursor(context, allocation, column, row);
 
+	// Keep the measurements of this frame, and start measuring the next.
+
+	guint hits;
+	guint misses;
+
+	m_tiles.take_stack_counts(hits, misses);
+
+	m_stats.m_stack_hits   = hits;
+	m_stats.m_stack_misses = misses;
+	m_stats.m_overlay      = seconds_since(overlay_start);
+	m_stats.m_total        = seconds_since(start);
+
+	m_frame_stats = m_stats;
+	m_stats = Enigma::RenderStats();
+
+	m_frame_times.push_back(m_frame_stats.m_total);
+
+	if (m_frame_times.size() > PROFILEFRAMES)
+		m_frame_times.pop_front();
+
+	if (m_profile)
+		draw_profile(context);
+
 	// Return TRUE to indicate all drawing has been done.
 
 	return true;
 }
 
+//---------------------------------------------------------------------
+// This private method draws the profile overlay in the top-left corner
+// of the view.  Below the last frame's measurements, a bar for each
+// recent frame shows its drawing time, with a line at 1/60 second.
+//---------------------------------------------------------------------
+// context: Cairo drawing context.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::draw_profile(const Cairo::RefPtr<Cairo::Context>& context)
+{
+	const Enigma::RenderStats& stats = m_frame_stats;
+
+	guint stacks  = stats.m_stack_hits + stats.m_stack_misses;
+	guint percent = stacks ? (stats.m_stack_hits * 100) / stacks : 0;
+
+	Glib::ustring layer;
+
+	if (stats.m_layer_redraws)
+		layer = _("drawn");
+	else if (stats.m_layer_scrolls)
+		layer = _("scrolled");
+	else
+		layer = _("copied");
+
+	auto milliseconds = [](double seconds)
+	{
+		return Glib::ustring::format(std::fixed,
+		                             std::setprecision(2),
+		                             seconds * 1000);
+	};
+
+	Glib::ustring text =
+		Glib::ustring::compose(_("Query: %1 ms   Tiles: %2 ms"),
+		                       milliseconds(stats.m_query),
+		                       milliseconds(stats.m_tiles))
+		+ "\n"
+		+ Glib::ustring::compose(_("Overlay: %1 ms   Total: %2 ms"),
+		                         milliseconds(stats.m_overlay),
+		                         milliseconds(stats.m_total))
+		+ "\n"
+		+ Glib::ustring::compose(_("Rooms: %1   Environment: %2   Floor: %3   Objects: %4"),
+		                         stats.m_rooms,
+		                         stats.m_environment,
+		                         stats.m_floor,
+		                         stats.m_objects)
+		+ "\n"
+		+ Glib::ustring::compose(_("Stack cache: %1%% of %2   Layer: %3"),
+		                         percent,
+		                         stacks,
+		                         layer);
+
+	Glib::RefPtr<Pango::Layout> layout = create_pango_layout(text);
+
+	int text_width;
+	int text_height;
+
+	layout->get_pixel_size(text_width, text_height);
+
+	int width  = std::max(text_width, PROFILEFRAMES * 2) + (2 * PROFILEMARGIN);
+	int height = text_height + PROFILEGRAPH + (3 * PROFILEMARGIN);
+	int bottom = height - PROFILEMARGIN;
+
+	context->save();
+
+	context->set_source_rgba(0, 0, 0, 0.75);
+	context->rectangle(0, 0, width, height);
+	context->fill();
+
+	context->set_source_rgb(1, 1, 1);
+	context->move_to(PROFILEMARGIN, PROFILEMARGIN);
+	layout->show_in_cairo_context(context);
+
+	// Draw a bar two pixels wide for each frame.  The graph's full height
+	// is 1/30 second.
+
+	int x = PROFILEMARGIN;
+
+	context->set_source_rgb(0.3, 0.8, 0.3);
+
+	for (double time : m_frame_times)
+	{
+		double bar = std::min(time * 30, 1.0) * PROFILEGRAPH;
+
+		context->rectangle(x, bottom - bar, 2, bar);
+		x += 2;
+	}
+
+	context->fill();
+
+	context->set_source_rgb(1, 0, 0);
+	context->set_line_width(1);
+	context->move_to(PROFILEMARGIN, bottom - (PROFILEGRAPH / 2) + 0.5);
+	context->line_to(width - PROFILEMARGIN, bottom - (PROFILEGRAPH / 2) + 0.5);
+	context->stroke();
+
+	context->restore();
+}
+
+//-------------------------------------------------------------------
+// This method is called when a mouse button is pressed.  The view
+// takes the keyboard focus, so keys move its cursor when several
+// views are shown.
+//-------------------------------------------------------------------
+// button_event: Pointer to GdkEventButton.
+// RETURN:       TRUE if the button press was handled.
+//-------------------------------------------------------------------
+
+bool Enigma::LevelView::on_button_press_event(GdkEventButton* button_event)
+{
+	grab_focus();
+	return true;
+}
+
 //------------------------------------------
 // Method to handle key press events.
 //------------------------------------------
@@ -402,6 +1226,8 @@ bool Enigma::LevelView::on_key_press_event(GdkEventKey* key_event)
 		int key_value = key_event->keyval;
 		int key_state = key_event->state;
 
+		Enigma::Position previous = m_cursor;
+
 		if (key_state & GDK_CONTROL_MASK )
 		{
 			switch (key_value)
@@ -421,6 +1247,11 @@ bool Enigma::LevelView::on_key_press_event(GdkEventKey* key_event)
 					handled = true;
 					break;
 
+				case GDK_KEY_p:
+					set_profile(!m_profile);
+					handled = true;
+					break;
+
 				default:
 					break;
 			}
@@ -447,9 +1278,9 @@ bool Enigma::LevelView::on_key_press_event(GdkEventKey* key_event)
 						if (key_state & GDK_SHIFT_MASK)
 							mark();            
 
-						// Update the view to show the changes.
+						// Update the view to show the cursor's new position.
 
-						update();
+						update_cursor(previous);
 					}
 
 					handled = true;
@@ -473,9 +1304,9 @@ bool Enigma::LevelView::on_key_press_event(GdkEventKey* key_event)
 						if (key_state & GDK_SHIFT_MASK)
 							mark();
 
-						// Update the view to show the changes.
+						// Update the view to show the cursor's new position.
 
-						update();
+						update_cursor(previous);
 					}
 
 					handled = true;
@@ -499,9 +1330,9 @@ bool Enigma::LevelView::on_key_press_event(GdkEventKey* key_event)
 						if (key_state & GDK_SHIFT_MASK)
 							mark();
 
-						// Update the view to show the changes.
+						// Update the view to show the cursor's new position.
 
-						update();
+						update_cursor(previous);
 					}
 
 					handled = true;
@@ -525,9 +1356,9 @@ bool Enigma::LevelView::on_key_press_event(GdkEventKey* key_event)
 						if (key_state & GDK_SHIFT_MASK)
 							mark();
 
-						// Update the view to show the changes.
+						// Update the view to show the cursor's new position.
 
-						update();
+						update_cursor(previous);
 					}
 
 					handled = true;
@@ -550,9 +1381,9 @@ bool Enigma::LevelView::on_key_press_event(GdkEventKey* key_event)
 						if (key_state & GDK_SHIFT_MASK)
 							mark();
 
-						// Update the view to show the changes.
+						// Update the view to show the cursor's new position.
 
-						update();
+						update_cursor(previous);
 					}
 
 					handled = true;
@@ -575,14 +1406,35 @@ bool Enigma::LevelView::on_key_press_event(GdkEventKey* key_event)
 						if (key_state & GDK_SHIFT_MASK)
 							mark();
 
-						// Update the view to show the changes.
+						// Update the view to show the cursor's new position.
 
-						update();
+						update_cursor(previous);
 					}
 
 					handled = true;
 					break;
 
+				case GDK_KEY_plus:
+				case GDK_KEY_equal:
+				case GDK_KEY_KP_Add:
+					// Zoom in, making rooms larger.
+
+					if (m_tiles.get_zoom() > 0)
+						set_zoom(m_tiles.get_zoom() - 1);
+
+					handled = true;
+					break;
+
+				case GDK_KEY_minus:
+				case GDK_KEY_KP_Subtract:
+					// Zoom out, making rooms smaller.
+
+					if (m_tiles.get_zoom() < (m_tiles.get_zoom_levels() - 1))
+						set_zoom(m_tiles.get_zoom() + 1);
+
+					handled = true;
+					break;
+
 				case GDK_KEY_Home:
 					// Set the map view to convenient location.
 
@@ -624,6 +1476,8 @@ bool Enigma::LevelView::on_key_press_event(GdkEventKey* key_event)
 void Enigma::LevelView::set_world(std::shared_ptr<Enigma::World> world)
 {
 	m_world = world;
+	m_layer_valid = false;
+	m_summary_valid = false;
 }
 
 //-------------------------------------------------------------
@@ -635,6 +1489,7 @@ void Enigma::LevelView::set_world(std::shared_ptr<Enigma::World> world)
 void Enigma::LevelView::set_filter(Enigma::Object::ID filter)
 {
 	m_filter = filter;
+	m_summary_valid = false;
 	
 	// Update the view to show the result of the object filter.
 
@@ -650,6 +1505,41 @@ Enigma::Position& Enigma::LevelView::get_cursor()
 	return m_cursor;
 }
 
+//-------------------------------------------------------------------
+// This method moves the cursor to a position, with the view centered
+// on it as far as the map allows.
+//-------------------------------------------------------------------
+// position: New cursor position.
+//-------------------------------------------------------------------
+
+void Enigma::LevelView::set_cursor(const Enigma::Position& position)
+{
+	m_cursor = position;
+	do_position();
+
+	unsigned short width  = m_view.m_ENA.m_east - m_view.m_WSB.m_east;
+	unsigned short height = m_view.m_ENA.m_north - m_view.m_WSB.m_north;
+
+	m_view.m_WSB.m_east = std::min(std::max(m_cursor.m_east - (width / 2),
+	                                        (int)Enigma::Position::MINIMUM),
+	                               Enigma::Position::MAXIMUM - width);
+
+	m_view.m_WSB.m_north = std::min(std::max(m_cursor.m_north - (height / 2),
+	                                         (int)Enigma::Position::MINIMUM),
+	                                Enigma::Position::MAXIMUM - height);
+
+	m_view.m_ENA.m_east  = m_view.m_WSB.m_east + width;
+	m_view.m_ENA.m_north = m_view.m_WSB.m_north + height;
+
+	m_view.m_WSB.m_above = m_cursor.m_above;
+	m_view.m_ENA.m_above = m_cursor.m_above;
+
+	// Keep the keyboard focus, so the cursor can be moved on from here.
+
+	grab_focus();
+	queue_draw();
+}
+
 //-----------------------------------------------------------------
 // This method changes the map view so it shows objects of the map.
 //-----------------------------------------------------------------
@@ -729,6 +1619,9 @@ void Enigma::LevelView::home()
 	align_range(m_cursor.m_north, m_view.m_WSB.m_north, m_view.m_ENA.m_north);
 	align_range(m_cursor.m_east, m_view.m_WSB.m_east, m_view.m_ENA.m_east);
 
+	m_view.m_WSB.m_above = m_cursor.m_above;
+	m_view.m_ENA.m_above = m_cursor.m_above;
+
 	// Update the view to show the changes.
 
 	update();
@@ -776,9 +1669,47 @@ void Enigma::LevelView::mark()
 		m_mark.m_ENA.m_east = m_mark_origin.m_east;
 	}
 
-	// Update the view to show the changes.
+	// Redraw the view to show the changes.  Only the markers have changed,
+	// so the objects are copied from the layer.
 
-	update();
+	queue_draw();
+}
+
+//---------------------------------------------------------------------
+// This private function gets the positions of objects, with each
+// position appearing only once.
+//---------------------------------------------------------------------
+// begin:     First object.
+// end:       Position after last object.
+// positions: List to receive the positions.
+//---------------------------------------------------------------------
+
+void get_positions(std::list<Enigma::Object>::const_iterator begin,
+                   std::list<Enigma::Object>::const_iterator end,
+                   std::list<Enigma::Position>& positions)
+{
+	for (; begin != end; ++ begin)
+		positions.push_back((*begin).m_position);
+
+	positions.sort([](const Enigma::Position& first,
+	                  const Enigma::Position& second)
+	{
+		if (first.m_above != second.m_above)
+			return first.m_above < second.m_above;
+
+		if (first.m_north != second.m_north)
+			return first.m_north < second.m_north;
+
+		return first.m_east < second.m_east;
+	});
+
+	positions.unique([](const Enigma::Position& first,
+	                    const Enigma::Position& second)
+	{
+		return (first.m_above == second.m_above)
+		    && (first.m_north == second.m_north)
+		    && (first.m_east == second.m_east);
+	});
 }
 
 //*-----------------------------------------*
@@ -798,6 +1729,15 @@ void Enigma::LevelView::erase()
 		m_mark.m_WSB = m_cursor;
 	}
 
+	// Ensure all marked levels have been loaded.  An edit is refused if
+	// a level could not be loaded, since it would see only part of it.
+
+	if (!m_world->load_levels(m_mark))
+	{
+		m_signal_message.emit(_("Unable to load the marked levels"));
+		return;
+	}
+
 	// Move all marked volume objects to a buffer.
 
 	std::list<std::list<Enigma::Object>::iterator> marked;
@@ -832,9 +1772,11 @@ void Enigma::LevelView::erase()
 	m_mark.m_ENA = m_cursor;
 	m_mark.m_WSB = m_cursor;
 
-	// Update the view to show the changes.
+	// Update the views to show the changes.
 
-	update();
+	std::list<Enigma::Position> positions;
+	get_positions(buffer.begin(), buffer.end(), positions);
+	changed(positions);
 }
 
 //-----------------------------------------------------------
@@ -845,7 +1787,7 @@ void Enigma::LevelView::cut()
 {  
 	// Clear any old objects in the editing buffer.
 
-	m_edit_buffer.clear();
+	m_edit_buffer->clear();
 
 	// Select the map volume to be cut.  If the marked volume has a size
 	// of only one room, set it to the cursor volume instead.
@@ -858,33 +1800,45 @@ void Enigma::LevelView::cut()
 		m_mark.m_WSB = m_cursor;
 	}
 
+	// Ensure all marked levels have been loaded.  An edit is refused if
+	// a level could not be loaded, since it would see only part of it.
+
+	if (!m_world->load_levels(m_mark))
+	{
+		m_signal_message.emit(_("Unable to load the marked levels"));
+		return;
+	}
+
 	// Move all marked volume objects to the editing buffer.
 
 	std::list<std::list<Enigma::Object>::iterator> marked;
 
 	m_world->m_objects.read(m_mark, marked);
-	m_world->m_objects.remove(marked, m_edit_buffer);
+	m_world->m_objects.remove(marked, *m_edit_buffer);
 
 	// Move all marked volume items to the editing buffer.
 
 	marked.clear();
 
 	m_world->m_items.read(m_mark, marked);
-	m_world->m_items.remove(marked, m_edit_buffer);
+	m_world->m_items.remove(marked, *m_edit_buffer);
 
 	// Move all marked volume players to the edit buffer.
 
 	marked.clear();
 
 	m_world->m_players.read(m_mark, marked);
-	m_world->m_players.remove(marked, m_edit_buffer);
+	m_world->m_players.remove(marked, *m_edit_buffer);
 
 	// Move all marked volume teleporters to the edit buffer.
 
 	marked.clear();
 
 	m_world->m_teleporters.read(m_mark, marked);
-	m_world->m_teleporters.remove(marked, m_edit_buffer);
+	m_world->m_teleporters.remove(marked, *m_edit_buffer);
+
+	std::list<Enigma::Position> positions;
+	get_positions(m_edit_buffer->begin(), m_edit_buffer->end(), positions);
 
 	// Change the map position of all objects to be an offset from a map
 	// position of (0, 0, 0), corresponding to the West-South-Below corner
@@ -892,8 +1846,8 @@ void Enigma::LevelView::cut()
 
 	std::list<Enigma::Object>::iterator object;
 
-	for (object = m_edit_buffer.begin();
-	     object != m_edit_buffer.end();
+	for (object = m_edit_buffer->begin();
+	     object != m_edit_buffer->end();
 	     ++ object)
 	{
 		(*object).m_position.m_above =
@@ -911,9 +1865,9 @@ void Enigma::LevelView::cut()
 	m_mark.m_ENA = m_cursor;
 	m_mark.m_WSB = m_cursor;
 
-	// Update the view to show the changes.
+	// Update the views to show the changes.
 
-	update();
+	changed(positions);
 }
 
 //-----------------------------------------------------------
@@ -924,7 +1878,7 @@ void Enigma::LevelView::copy()
 {
 	// Clear any old objects in the editing buffer.
 
-	m_edit_buffer.clear();
+	m_edit_buffer->clear();
 
 	// Select the map volume to be cut.  If the marked volume has a size
 	// of only one room, use the cursor volume instead.
@@ -937,12 +1891,21 @@ void Enigma::LevelView::copy()
 		m_mark.m_WSB = m_cursor;
 	}
 
+	// Ensure all marked levels have been loaded.  An edit is refused if
+	// a level could not be loaded, since it would see only part of it.
+
+	if (!m_world->load_levels(m_mark))
+	{
+		m_signal_message.emit(_("Unable to load the marked levels"));
+		return;
+	}
+
 	// Get a copy of all marked objects from all object lists.
 
-	m_world->m_objects.copy(m_mark, m_edit_buffer);
-	m_world->m_items.copy(m_mark, m_edit_buffer);
-	m_world->m_players.copy(m_mark, m_edit_buffer);
-	m_world->m_teleporters.copy(m_mark, m_edit_buffer);
+	m_world->m_objects.copy(m_mark, *m_edit_buffer);
+	m_world->m_items.copy(m_mark, *m_edit_buffer);
+	m_world->m_players.copy(m_mark, *m_edit_buffer);
+	m_world->m_teleporters.copy(m_mark, *m_edit_buffer);
 
 	// Change the map position of all objects to be an offset from a map
 	// location of (0, 0, 0), corresponding to the upper-top-left corner
@@ -950,8 +1913,8 @@ void Enigma::LevelView::copy()
 
 	std::list<Enigma::Object>::iterator object;
 
-	for (object = m_edit_buffer.begin();
-	     object != m_edit_buffer.end();
+	for (object = m_edit_buffer->begin();
+	     object != m_edit_buffer->end();
 	     ++ object)
 	{
 		(*object).m_position.m_above =
@@ -981,9 +1944,10 @@ void Enigma::LevelView::paste()
 
 	Enigma::Object new_object;
 	std::list<Enigma::Object>::iterator object;
+	std::list<Enigma::Object> inserted;
 
-	for (object = m_edit_buffer.begin();
-	     object != m_edit_buffer.end();
+	for (object = m_edit_buffer->begin();
+	     object != m_edit_buffer->end();
 	     ++ object )
 	{
 		new_object = (*object);
@@ -1025,12 +1989,90 @@ void Enigma::LevelView::paste()
 				default:
 					break;
 			}
+
+			inserted.push_back(new_object);
 		}
 	}
 
-	// Update the view to show the changes.
+	// Update the views to show the changes.
 
-	update();
+	std::list<Enigma::Position> positions;
+	get_positions(inserted.begin(), inserted.end(), positions);
+	changed(positions);
+}
+
+//---------------------------------------------------------------------
+// This private method updates the rooms changed by an edit, and
+// reports them so other views of the world update only those rooms.
+//---------------------------------------------------------------------
+// positions: Positions of changed rooms.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::changed(const std::list<Enigma::Position>& positions)
+{
+	update(positions);
+
+	// Any marker tiles must also be removed from the view.
+
+	queue_draw();
+	m_signal_changed.emit(positions);
+}
+
+//---------------------------------------------------------------------
+// This method sets the editing buffer, so views sharing it can cut or
+// copy objects in one view and paste them in another.
+//---------------------------------------------------------------------
+// buffer: Objects editing buffer.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::set_edit_buffer(
+	std::shared_ptr<std::list<Enigma::Object>> buffer)
+{
+	m_edit_buffer = buffer;
+}
+
+//---------------------------------------------------------------------
+// This method returns the editing buffer.
+//---------------------------------------------------------------------
+// RETURN: Objects editing buffer.
+//---------------------------------------------------------------------
+
+std::shared_ptr<std::list<Enigma::Object>> Enigma::LevelView::get_edit_buffer()
+{
+	return m_edit_buffer;
+}
+
+//---------------------------------------------------------------------
+// This method shows or hides the profile overlay, which shows how long
+// the last frame took to draw and a graph of recent frame times.
+//---------------------------------------------------------------------
+// profile: TRUE to show the profile overlay.
+//---------------------------------------------------------------------
+
+void Enigma::LevelView::set_profile(bool profile)
+{
+	m_profile = profile;
+	queue_draw();
+}
+
+//---------------------------------------------------------------------
+// This method returns TRUE if the profile overlay is shown.
+//---------------------------------------------------------------------
+
+bool Enigma::LevelView::get_profile() const
+{
+	return m_profile;
+}
+
+//---------------------------------------------------------------------
+// This method returns the measurements of the last frame drawn.
+//---------------------------------------------------------------------
+// RETURN: Frame measurements.
+//---------------------------------------------------------------------
+
+const Enigma::RenderStats& Enigma::LevelView::get_render_stats() const
+{
+	return m_frame_stats;
 }
 
 //------------------------------
@@ -1039,9 +2081,176 @@ void Enigma::LevelView::paste()
 
 void Enigma::LevelView::update()
 {
+	m_layer_valid = false;
 	queue_draw();
 }
 
+//-------------------------------------------------------------------
+// This private method updates the view after the cursor has moved.
+// If the view still shows the same rooms, only the previous and new
+// cursor rooms are redrawn.
+//-------------------------------------------------------------------
+// previous: Previous cursor position.
+//-------------------------------------------------------------------
+
+void Enigma::LevelView::update_cursor(const Enigma::Position& previous)
+{
+	if (m_layer_valid
+	    && equal_volumes(m_layer_view, m_view)
+	    && (previous.m_above == m_cursor.m_above))
+	{
+		queue_draw_room(previous);
+		queue_draw_room(m_cursor);
+	}
+	else
+		queue_draw();
+}
+
+//------------------------------------------------------------------
+// This private method redraws the visible room at a position.
+//------------------------------------------------------------------
+// position: Position of room.
+//------------------------------------------------------------------
+
+void Enigma::LevelView::queue_draw_room(const Enigma::Position& position)
+{
+	// The profile overlay changes with every frame, so draw it too.
+
+	if (m_profile)
+	{
+		queue_draw();
+		return;
+	}
+
+	int size   = m_tiles.get_tile_size();
+	int height = get_allocated_height();
+
+	if ((position.m_above == m_cursor.m_above)
+	    && (position.m_north >= m_view.m_WSB.m_north)
+	    && (position.m_north <= m_view.m_ENA.m_north)
+	    && (position.m_east >= m_view.m_WSB.m_east)
+	    && (position.m_east <= m_view.m_ENA.m_east))
+	{
+		int column = position.m_east - m_view.m_WSB.m_east;
+		int row    = position.m_north - m_view.m_WSB.m_north;
+
+		queue_draw_area(column * size,
+		                height - size - (row * size),
+		                size,
+		                size);
+	}
+}
+
+//-------------------------------------------------------------------
+// This method updates only the rooms at the provided positions, if
+// they are visible.
+//-------------------------------------------------------------------
+// positions: Positions of rooms to be updated.
+//-------------------------------------------------------------------
+
+void Enigma::LevelView::update(const std::list<Enigma::Position>& positions)
+{
+	// Rooms on the layer are drawn again in place.  If the layer is out of
+	// date anyway, it will be drawn completely.
+
+	Cairo::RefPtr<Cairo::Context> context;
+
+	if (m_layer_valid && equal_volumes(m_layer_view, m_view))
+		context = Cairo::Context::create(m_layer);
+	else
+		m_layer_valid = false;
+
+	// Find the colours of the rooms in the level summary again, wherever
+	// they are on the level.  If a room lies outside the summary, the
+	// summary and layer are found and drawn again completely.
+
+	if (m_summary_valid)
+	{
+		std::list<Enigma::Position> changed;
+		std::list<Enigma::Position>::const_iterator position;
+
+		for (position = positions.begin();
+		     position != positions.end();
+		     ++ position)
+		{
+			if ((*position).m_above != m_summary.m_volume.m_WSB.m_above)
+				continue;
+
+			if (((*position).m_north < m_summary.m_volume.m_WSB.m_north)
+			    || ((*position).m_north > m_summary.m_volume.m_ENA.m_north)
+			    || ((*position).m_east < m_summary.m_volume.m_WSB.m_east)
+			    || ((*position).m_east > m_summary.m_volume.m_ENA.m_east))
+			{
+				m_summary_valid = false;
+				m_layer_valid = false;
+				context = Cairo::RefPtr<Cairo::Context>();
+				queue_draw();
+				break;
+			}
+
+			std::list<std::list<Enigma::Object>::iterator> buffer;
+			std::list<std::list<Enigma::Object>::iterator>::iterator object;
+			Enigma::Position room = *position;
+
+			m_world->m_objects.read(room, buffer);
+			m_world->m_items.read(room, buffer);
+			m_world->m_players.read(room, buffer);
+			m_world->m_teleporters.read(room, buffer);
+
+			Enigma::LevelSummary::Room key((*position).m_north, (*position).m_east);
+			guint32 value = 0;
+
+			for (object = buffer.begin(); object != buffer.end(); ++ object)
+				summarize(*(*object), value);
+
+			if (value)
+				m_summary.m_rooms[key] = value;
+			else
+				m_summary.m_rooms.erase(key);
+
+			changed.push_back(*position);
+		}
+
+		if (m_summary_valid && !changed.empty())
+			m_signal_summary.emit(m_summary, changed);
+	}
+
+	int size   = m_tiles.get_tile_size();
+	int height = get_allocated_height();
+
+	std::list<Enigma::Position>::const_iterator position;
+
+	for (position = positions.begin();
+	     position != positions.end();
+	     ++ position)
+	{
+		if (((*position).m_above == m_cursor.m_above)
+		    && ((*position).m_north >= m_view.m_WSB.m_north)
+		    && ((*position).m_north <= m_view.m_ENA.m_north)
+		    && ((*position).m_east >= m_view.m_WSB.m_east)
+		    && ((*position).m_east <= m_view.m_ENA.m_east))
+		{
+			if (context)
+			{
+				int column = (*position).m_east - m_view.m_WSB.m_east;
+				int row    = (*position).m_north - m_view.m_WSB.m_north;
+
+				context->set_source_rgb(BACKGROUND_R, BACKGROUND_G, BACKGROUND_B);
+				context->rectangle(column * size,
+				                   height - size - (row * size),
+				                   size,
+				                   size);
+				context->fill();
+
+				Enigma::Position room = *position;
+				draw_room(context, room);
+			}
+
+			queue_draw_room(*position);
+		}
+	}
+}
+
 //---------------------------------------------
 // This method returns the map position signal.
 //---------------------------------------------
@@ -1051,11 +2260,82 @@ Enigma::LevelView::type_signal_position Enigma::LevelView::signal_position()
 	return m_signal_position;
 }
 
-//-----------------------------------------------------------
-// This method emits a signal containing the cursor position.
-//-----------------------------------------------------------
+//---------------------------------------------------------------------
+// This method returns the level summary signal, which provides the
+// summary after it has been found again, with the positions of the
+// changed rooms (or none if the whole summary has changed).
+//---------------------------------------------------------------------
+
+Enigma::LevelView::type_signal_summary Enigma::LevelView::signal_summary()
+{
+	return m_signal_summary;
+}
+
+//-------------------------------------------------------------------
+// This method returns the changed rooms signal, which provides the
+// positions of rooms changed by editing in this view.
+//-------------------------------------------------------------------
+
+Enigma::LevelView::type_signal_changed Enigma::LevelView::signal_changed()
+{
+	return m_signal_changed;
+}
+
+//----------------------------------------------------------------
+// This method returns the view signal, which provides the visible
+// rooms after the view has moved.
+//----------------------------------------------------------------
+
+Enigma::LevelView::type_signal_view Enigma::LevelView::signal_view()
+{
+	return m_signal_view;
+}
+
+//----------------------------------------------------------------
+// This method returns the message signal, which provides messages
+// for the user, such as why an edit was refused.
+//----------------------------------------------------------------
+
+Enigma::LevelView::type_signal_message Enigma::LevelView::signal_message()
+{
+	return m_signal_message;
+}
+
+//---------------------------------------------------------------------
+// This method emits a signal containing the cursor position.  While
+// the view is shown, the signal is held until the next frame is drawn,
+// so a repeating cursor key refreshes the other views once per frame
+// rather than once per key press.
+//---------------------------------------------------------------------
 
 void Enigma::LevelView::do_position()
 {	  
+	if (!get_mapped())
+	{
+		m_signal_position.emit(m_cursor);
+		return;
+	}
+
+	if (!m_position_tick)
+	{
+		m_position_tick =
+			add_tick_callback(sigc::mem_fun(*this,
+			                                &Enigma::LevelView::on_position_tick));
+	}
+}
+
+//---------------------------------------------------------------------
+// This private method is called by the frame clock when a cursor
+// position is waiting to be sent.  The latest position is sent.
+//---------------------------------------------------------------------
+// clock:  Frame clock of view.
+// RETURN: FALSE to remove the tick callback.
+//---------------------------------------------------------------------
+
+bool Enigma::LevelView::on_position_tick(
+	const Glib::RefPtr<Gdk::FrameClock>& clock)
+{
+	m_position_tick = 0;
 	m_signal_position.emit(m_cursor);
+	return false;
 }
@@ -21,9 +21,14 @@
 #ifndef __LEVELVIEW_H__
 #define __LEVELVIEW_H__
 
+#include <list>
+#include <deque>
+#include <vector>
 #include <gtkmm/drawingarea.h>
 #include "Volume.h"
+#include "LevelSummary.h"
 #include "Tiles.h"
+#include "RenderStats.h"
 
 namespace Enigma
 {
@@ -37,21 +42,52 @@ namespace Enigma
 			LevelView();
 			void home();
 			void update();
+			void update(const std::list<Enigma::Position>& positions);
 			void set_world(std::shared_ptr<Enigma::World> world);
 			void set_filter(Enigma::Object::ID m_filter);
 			Enigma::Position& get_cursor();
+			void set_cursor(const Enigma::Position& position);
+			void set_edit_buffer(std::shared_ptr<std::list<Enigma::Object>> buffer);
+			std::shared_ptr<std::list<Enigma::Object>> get_edit_buffer();
+			void set_profile(bool profile);
+			bool get_profile() const;
+			const Enigma::RenderStats& get_render_stats() const;
 
 			// Map position signal accessor.
 
 			typedef sigc::signal<void, const Enigma::Position&> type_signal_position;
 			type_signal_position signal_position();
 
+			// Level summary signal accessor.
+
+			typedef sigc::signal<void,
+			                     const Enigma::LevelSummary&,
+			                     const std::list<Enigma::Position>&> type_signal_summary;
+
+			type_signal_summary signal_summary();
+
+			// Changed rooms signal accessor.
+
+			typedef sigc::signal<void, const std::list<Enigma::Position>&> type_signal_changed;
+			type_signal_changed signal_changed();
+
+			// View signal accessor.
+
+			typedef sigc::signal<void, const Enigma::Volume&> type_signal_view;
+			type_signal_view signal_view();
+
+			// Message signal accessor.
+
+			typedef sigc::signal<void, const Glib::ustring&> type_signal_message;
+			type_signal_message signal_message();
+
 			// Overridden base class methods.
 
 			void on_size_allocate(Gtk::Allocation& allocation) override;
 			void on_map() override;
 			bool on_draw(const Cairo::RefPtr<Cairo::Context>& context) override;
 			bool on_key_press_event(GdkEventKey* key_event) override;
+			bool on_button_press_event(GdkEventButton* button_event) override;
 			
 			void get_preferred_width_vfunc(int& minimum_width,
 			                               int& natural_width) const override;
@@ -63,11 +99,42 @@ namespace Enigma
 			// Private methods.
 
 			void do_position();
+			bool on_position_tick(const Glib::RefPtr<Gdk::FrameClock>& clock);
+			void set_view_size();
+			void set_zoom(guint zoom);
+			void summarize(const Enigma::Object& object, guint32& value);
+			void build_summary();
+			void draw_summary();
+			void draw_room(const Cairo::RefPtr<Cairo::Context>& context,
+			               Enigma::Position& room);
+
+			void gather_room(Enigma::Position& room,
+			                 std::vector<Enigma::Object*>& objects);
+
+			void draw_objects(const Cairo::RefPtr<Cairo::Context>& context,
+			                  Gtk::Allocation allocation,
+			                  unsigned short column,
+			                  unsigned short row,
+			                  const std::vector<Enigma::Object*>& objects);
+
+			void draw_bands(const Cairo::RefPtr<Cairo::Context>& context,
+			                const std::vector<std::vector<Enigma::Object*>>& rooms,
+			                int columns,
+			                int rows);
+
+			Cairo::RefPtr<Cairo::ImageSurface> create_layer();
+			bool layer_fits(const Cairo::RefPtr<Cairo::ImageSurface>& layer);
+			void draw_layer();
+			bool scroll_layer();
+			void update_cursor(const Enigma::Position& previous);
+			void queue_draw_room(const Enigma::Position& position);
+			void draw_profile(const Cairo::RefPtr<Cairo::Context>& context);
 			void mark();
 			void erase();
 			void cut();
 			void copy();
 			void paste();
+			void changed(const std::list<Enigma::Position>& positions);
 
 			// Private data.
 
@@ -78,8 +145,25 @@ namespace Enigma
 			Enigma::Position m_mark_origin;            // Origin of marked volume.
 			Enigma::Position m_cursor;                 // Position of cursor.
 			type_signal_position m_signal_position;    // Position signal server.
-			std::list<Enigma::Object> m_edit_buffer;   // Objects editing buffer.
+			type_signal_summary m_signal_summary;      // Summary signal server.
+			type_signal_view m_signal_view;            // View signal server.
+			type_signal_changed m_signal_changed;      // Changed rooms signal server.
+			type_signal_message m_signal_message;      // Message signal server.
+			std::shared_ptr<std::list<Enigma::Object>> m_edit_buffer;  // Editing buffer.
 			Enigma::Object::ID m_filter;               // Object viewing filter.
+			Cairo::RefPtr<Cairo::ImageSurface> m_layer;  // Drawn objects.
+			Cairo::RefPtr<Cairo::ImageSurface> m_layer_back;  // Scroll copy.
+			Enigma::Volume m_layer_view;               // View drawn on layer.
+			bool m_layer_valid;                        // TRUE if layer is current.
+			int m_layer_size;                          // Room size on layer.
+			int m_layer_scale;                         // Layer pixels per unit.
+			Enigma::LevelSummary m_summary;            // Room colours of level.
+			bool m_summary_valid;                      // TRUE if summary is current.
+			guint m_position_tick;                     // Position tick callback ID.
+			bool m_profile;                            // TRUE if profile is shown.
+			Enigma::RenderStats m_stats;               // Measurements of next frame.
+			Enigma::RenderStats m_frame_stats;         // Measurements of last frame.
+			std::deque<double> m_frame_times;          // Recent frame times.
 	};
 }
 
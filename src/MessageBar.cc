@@ -35,3 +35,24 @@ void Enigma::MessageBar::set_position(const Enigma::Position& position)
      	                      position.m_above);
 	set_label(string);
 }
+
+//-------------------------------------------------------
+// This method displays the progress of loading a world.
+//-------------------------------------------------------
+// filename: Name of world file being loaded.
+// index:    Progress index.
+// size:     Progress index when loading is done.
+//-------------------------------------------------------
+
+void Enigma::MessageBar::set_progress(const Glib::ustring& filename,
+                                      gsize index,
+                                      gsize size)
+{
+	int percent = (size > 0) ? (int)((index * 100) / size) : 0;
+
+	Glib::ustring string =
+		Glib::ustring::compose(_("Loading %1   %2%%   (Esc to cancel)"),
+		                       filename,
+		                       percent);
+	set_label(string);
+}
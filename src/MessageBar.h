@@ -31,6 +31,10 @@ namespace Enigma
 			// Public methods.
 
 			void set_position(const Enigma::Position& position);
+
+			void set_progress(const Glib::ustring& filename,
+			                  gsize index,
+			                  gsize size);
 	};
 }
 
@@ -0,0 +1,353 @@
+// "World in the Wine Cellar" world creator for "Enigma in the Wine Cellar".
+// Copyright (C) 2021 Chris Sterne <chris_sterne@hotmail.com>
+//
+// This file is the MiniMap class implementation.  The MiniMap class displays
+// an overview of the whole level being viewed, and moves the level view's
+// cursor to a room clicked on.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cmath>
+#include "MiniMap.h"
+
+//-------------------
+// Local declarations
+//-------------------
+
+#define BACKGROUND_R 0      // Background colour.
+#define BACKGROUND_G 0
+#define BACKGROUND_B 0
+
+#define IMAGESIZE 256       // Largest width or height of level image.
+#define MAPSIZE 200         // Preferred width of widget.
+
+//-------------------------
+// This is the constructor.
+//-------------------------
+
+Enigma::MiniMap::MiniMap()
+{
+	set_has_window(true);
+	set_vexpand(true);
+	add_events(Gdk::BUTTON_PRESS_MASK);
+
+	m_reduction = 1;
+	m_scale = 1;
+	m_x = 0;
+	m_y = 0;
+}
+
+//-------------------------------------------------
+// Method to get preferred width of MiniMap widget.
+//-------------------------------------------------
+
+void Enigma::MiniMap::get_preferred_width_vfunc(int& minimum_width,
+                                                int& natural_width) const
+{
+	minimum_width = MAPSIZE;
+	natural_width = minimum_width;
+}
+
+//--------------------------------------------------
+// Method to get preferred height of MiniMap widget.
+//--------------------------------------------------
+
+void Enigma::MiniMap::get_preferred_height_vfunc(int& minimum_height,
+                                                 int& natural_height) const
+{
+	minimum_height = MAPSIZE;
+	natural_height = minimum_height;
+}
+
+//---------------------------------------------------------------------
+// This method sets the level image from a level summary, which holds
+// the colour of every occupied room on the level.  A large level is
+// reduced so the image is at most IMAGESIZE pixels across, and the
+// image is built at that size straight from the occupied rooms.  Only
+// the image pixels of changed rooms are found again.
+//---------------------------------------------------------------------
+// summary:   Room colours of level.
+// positions: Positions of changed rooms, or empty if all have changed.
+//---------------------------------------------------------------------
+
+void Enigma::MiniMap::set_summary(const Enigma::LevelSummary& summary,
+                                  const std::list<Enigma::Position>& positions)
+{
+	if (positions.empty() || !m_image)
+	{
+		m_volume = summary.m_volume;
+		m_pixels.clear();
+
+		if (summary.m_rooms.empty())
+			m_image = Cairo::RefPtr<Cairo::ImageSurface>();
+		else
+		{
+			gsize width  = (gsize)m_volume.m_ENA.m_east - m_volume.m_WSB.m_east + 1;
+			gsize height = (gsize)m_volume.m_ENA.m_north - m_volume.m_WSB.m_north + 1;
+
+			m_reduction = (std::max(width, height) + IMAGESIZE - 1) / IMAGESIZE;
+
+			m_image = Cairo::ImageSurface::create(Cairo::FORMAT_RGB24,
+				(width + m_reduction - 1) / m_reduction,
+				(height + m_reduction - 1) / m_reduction);
+
+			// Each pixel takes the colour of its room whose objects are drawn
+			// last, which the summary keeps in the top byte of its values.
+
+			m_pixels.assign((gsize)m_image->get_width() * m_image->get_height(), 0);
+
+			std::map<Enigma::LevelSummary::Room, guint32>::const_iterator room;
+
+			for (room = summary.m_rooms.begin();
+			     room != summary.m_rooms.end();
+			     ++ room)
+			{
+				gsize x = (room->first.second - m_volume.m_WSB.m_east) / m_reduction;
+				gsize y = (room->first.first - m_volume.m_WSB.m_north) / m_reduction;
+				guint32& value = m_pixels[(y * m_image->get_width()) + x];
+
+				value = std::max(value, room->second);
+			}
+
+			m_image->flush();
+
+			for (int y = 0; y < m_image->get_height(); ++ y)
+			{
+				for (int x = 0; x < m_image->get_width(); ++ x)
+					draw_pixel(x, y);
+			}
+
+			m_image->mark_dirty();
+		}
+	}
+	else
+	{
+		m_image->flush();
+
+		std::list<Enigma::Position>::const_iterator position;
+
+		for (position = positions.begin();
+		     position != positions.end();
+		     ++ position)
+		{
+			if (((*position).m_above == m_volume.m_WSB.m_above)
+			    && ((*position).m_north >= m_volume.m_WSB.m_north)
+			    && ((*position).m_north <= m_volume.m_ENA.m_north)
+			    && ((*position).m_east >= m_volume.m_WSB.m_east)
+			    && ((*position).m_east <= m_volume.m_ENA.m_east))
+			{
+				find_pixel(summary,
+				           ((*position).m_east - m_volume.m_WSB.m_east) / m_reduction,
+				           ((*position).m_north - m_volume.m_WSB.m_north) / m_reduction);
+			}
+		}
+
+		m_image->mark_dirty();
+	}
+
+	queue_draw();
+}
+
+//---------------------------------------------------------------------
+// This private method finds the value of one pixel of the level image
+// again from the occupied rooms it covers, and sets the pixel.
+//---------------------------------------------------------------------
+// summary: Room colours of level.
+// x:       Image column, from the west.
+// y:       Image row, from the south.
+//---------------------------------------------------------------------
+
+void Enigma::MiniMap::find_pixel(const Enigma::LevelSummary& summary,
+                                 int x,
+                                 int y)
+{
+	int west  = m_volume.m_WSB.m_east + (x * m_reduction);
+	int east  = std::min(west + m_reduction - 1, (int)m_volume.m_ENA.m_east);
+	int south = m_volume.m_WSB.m_north + (y * m_reduction);
+	int north = std::min(south + m_reduction - 1, (int)m_volume.m_ENA.m_north);
+
+	guint32 value = 0;
+
+	for (int room_north = south; room_north <= north; ++ room_north)
+	{
+		std::map<Enigma::LevelSummary::Room, guint32>::const_iterator room =
+			summary.m_rooms.lower_bound(Enigma::LevelSummary::Room(room_north, west));
+
+		for (;
+		     (room != summary.m_rooms.end())
+		     && (room->first.first == room_north)
+		     && (room->first.second <= east);
+		     ++ room)
+		{
+			value = std::max(value, room->second);
+		}
+	}
+
+	m_pixels[((gsize)y * m_image->get_width()) + x] = value;
+	draw_pixel(x, y);
+}
+
+//---------------------------------------------------------------------
+// This private method sets one pixel of the level image from its
+// value.
+//---------------------------------------------------------------------
+// x: Image column, from the west.
+// y: Image row, from the south.
+//---------------------------------------------------------------------
+
+void Enigma::MiniMap::draw_pixel(int x, int y)
+{
+	// Image rows begin at the top, which is the north.
+
+	guint32* pixel = (guint32*)(m_image->get_data()
+		+ ((m_image->get_height() - 1 - y) * m_image->get_stride())) + x;
+
+	*pixel = m_pixels[((gsize)y * m_image->get_width()) + x] & 0xffffff;
+}
+
+//-----------------------------------------------------
+// This method sets the rooms shown by the level view.
+//-----------------------------------------------------
+// view: Visible rooms of level view.
+//-----------------------------------------------------
+
+void Enigma::MiniMap::set_view(const Enigma::Volume& view)
+{
+	m_view = view;
+	queue_draw();
+}
+
+//-------------------------------------------
+// This method sets the position of the cursor.
+//-------------------------------------------
+// position: Position of cursor.
+//-------------------------------------------
+
+void Enigma::MiniMap::set_position(const Enigma::Position& position)
+{
+	m_position = position;
+	queue_draw();
+}
+
+//---------------------------------------------------------------------
+// This method is called when the widget needs to be redrawn.  The level
+// image is scaled to fit the widget, and the rooms of the level view
+// and the cursor are outlined over it.
+//---------------------------------------------------------------------
+// context: Cairo context for drawing.
+// RETURN:  TRUE to indicate all drawing has been done.
+//---------------------------------------------------------------------
+
+bool Enigma::MiniMap::on_draw(const Cairo::RefPtr<Cairo::Context>& context)
+{
+	Gtk::Allocation allocation = get_allocation();
+
+	context->set_source_rgb(BACKGROUND_R, BACKGROUND_G, BACKGROUND_B);
+	context->paint();
+
+	if (!m_image || (m_position.m_above != m_volume.m_WSB.m_above))
+		return true;
+
+	int width  = m_volume.m_ENA.m_east - m_volume.m_WSB.m_east + 1;
+	int height = m_volume.m_ENA.m_north - m_volume.m_WSB.m_north + 1;
+
+	m_scale = std::min((double)allocation.get_width() / width,
+	                   (double)allocation.get_height() / height);
+
+	m_x = (allocation.get_width() - (width * m_scale)) / 2;
+	m_y = (allocation.get_height() + (height * m_scale)) / 2;
+
+	// Draw the level image without smoothing, so rooms stay distinct.
+
+	Cairo::RefPtr<Cairo::SurfacePattern> pattern =
+		Cairo::SurfacePattern::create(m_image);
+
+	pattern->set_filter(Cairo::FILTER_NEAREST);
+
+	context->save();
+	context->translate(m_x,
+	                   m_y - (m_image->get_height() * m_reduction * m_scale));
+	context->scale(m_reduction * m_scale, m_reduction * m_scale);
+	context->set_source(pattern);
+	context->paint();
+	context->restore();
+
+	// Outline the rooms shown by the level view.
+
+	context->set_source_rgb(1, 1, 1);
+	context->set_line_width(1);
+	context->rectangle(
+		m_x + ((m_view.m_WSB.m_east - m_volume.m_WSB.m_east) * m_scale),
+		m_y - ((m_view.m_ENA.m_north + 1 - m_volume.m_WSB.m_north) * m_scale),
+		(m_view.m_ENA.m_east - m_view.m_WSB.m_east + 1) * m_scale,
+		(m_view.m_ENA.m_north - m_view.m_WSB.m_north + 1) * m_scale);
+
+	context->stroke();
+
+	// Mark the cursor with a block large enough to be seen.
+
+	double size = std::max(m_scale, 3.0);
+
+	context->set_source_rgb(1, 0, 0);
+	context->rectangle(
+		m_x + ((m_position.m_east - m_volume.m_WSB.m_east + 0.5) * m_scale) - (size / 2),
+		m_y - ((m_position.m_north - m_volume.m_WSB.m_north + 0.5) * m_scale) - (size / 2),
+		size,
+		size);
+
+	context->fill();
+	return true;
+}
+
+//---------------------------------------------------------------------
+// This method is called when a mouse button is pressed.  A room
+// clicked on with the first button is sent as the new cursor position.
+//---------------------------------------------------------------------
+// button_event: Pointer to GdkEventButton.
+// RETURN:       TRUE if the button press was handled.
+//---------------------------------------------------------------------
+
+bool Enigma::MiniMap::on_button_press_event(GdkEventButton* button_event)
+{
+	if (!m_image || (button_event->button != 1))
+		return false;
+
+	int east  = (int)std::floor((button_event->x - m_x) / m_scale);
+	int north = (int)std::floor((m_y - button_event->y) / m_scale);
+
+	Enigma::Position position;
+
+	position.m_above = m_volume.m_WSB.m_above;
+
+	position.m_east = std::min(std::max(east + m_volume.m_WSB.m_east,
+	                                    (int)m_volume.m_WSB.m_east),
+	                           (int)m_volume.m_ENA.m_east);
+
+	position.m_north = std::min(std::max(north + m_volume.m_WSB.m_north,
+	                                     (int)m_volume.m_WSB.m_north),
+	                            (int)m_volume.m_ENA.m_north);
+
+	m_signal_position.emit(position);
+	return true;
+}
+
+//---------------------------------------------
+// This method returns the map position signal.
+//---------------------------------------------
+
+Enigma::MiniMap::type_signal_position Enigma::MiniMap::signal_position()
+{
+	return m_signal_position;
+}
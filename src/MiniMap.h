@@ -0,0 +1,80 @@
+// "World in the Wine Cellar" world creator for "Enigma in the Wine Cellar".
+// Copyright (C) 2021 Chris Sterne <chris_sterne@hotmail.com>
+//
+// This file is the MiniMap class header.  The MiniMap class displays an
+// overview of the whole level being viewed, and moves the level view's
+// cursor to a room clicked on.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __MINIMAP_H__
+#define __MINIMAP_H__
+
+#include <list>
+#include <vector>
+#include <gtkmm/drawingarea.h>
+#include "LevelSummary.h"
+
+namespace Enigma
+{
+	class MiniMap : public Gtk::DrawingArea
+	{
+		public:
+			// Public methods.
+
+			MiniMap();
+			void set_summary(const Enigma::LevelSummary& summary,
+			                 const std::list<Enigma::Position>& positions);
+
+			void set_view(const Enigma::Volume& view);
+			void set_position(const Enigma::Position& position);
+
+			// Map position signal accessor.
+
+			typedef sigc::signal<void, const Enigma::Position&> type_signal_position;
+			type_signal_position signal_position();
+
+			// Overridden base class methods.
+
+			bool on_draw(const Cairo::RefPtr<Cairo::Context>& context) override;
+			bool on_button_press_event(GdkEventButton* button_event) override;
+
+			void get_preferred_width_vfunc(int& minimum_width,
+			                               int& natural_width) const override;
+
+			void get_preferred_height_vfunc(int& minimum_height,
+			                                int& natural_height) const override;
+
+		private:
+			// Private methods.
+
+			void find_pixel(const Enigma::LevelSummary& summary, int x, int y);
+			void draw_pixel(int x, int y);
+
+			// Private data.
+
+			Cairo::RefPtr<Cairo::ImageSurface> m_image;  // Reduced level image.
+			std::vector<guint32> m_pixels;             // Summary values of image.
+			Enigma::Volume m_volume;                   // Rooms in level summary.
+			int m_reduction;                           // Rooms across each pixel.
+			Enigma::Volume m_view;                     // Rooms in level view.
+			Enigma::Position m_position;               // Position of cursor.
+			double m_scale;                            // Drawn pixels per room.
+			double m_x;                                // Drawn image left edge.
+			double m_y;                                // Drawn image bottom edge.
+			type_signal_position m_signal_position;    // Position signal server.
+	};
+}
+
+#endif // __MINIMAP_H__
@@ -18,6 +18,7 @@
 // with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <glibmm/i18n.h>
+#include "Hash.h"
 #include "Object.h"
 
 //--------------------
@@ -354,3 +355,86 @@ TYPE = %2    SURFACE = %3    ROTATION = %4\
       teleport_text,
       signal_text);
 }
+
+//------------------------------------------------------------------
+// This method returns TRUE if two objects are the same.  Only data
+// meaningful for the type of object is compared, since other data
+// may be left unset.
+//------------------------------------------------------------------
+// object: Object to be compared.
+// RETURN: TRUE if the objects are the same.
+//------------------------------------------------------------------
+
+bool Enigma::Object::operator==(const Enigma::Object& object) const
+{
+	if ((m_type != object.m_type)
+	    || (m_id != object.m_id)
+	    || (m_position.m_above != object.m_position.m_above)
+	    || (m_position.m_north != object.m_position.m_north)
+	    || (m_position.m_east != object.m_position.m_east)
+	    || (m_surface != object.m_surface)
+	    || (m_rotation != object.m_rotation)
+	    || (m_sense != object.m_sense)
+	    || (m_state != object.m_state)
+	    || (m_visibility != object.m_visibility)
+	    || (m_presence != object.m_presence))
+	{
+		return false;
+	}
+
+	if (m_type == Enigma::Object::Type::PLAYER)
+		return (m_active == object.m_active);
+
+	if (m_type == Enigma::Object::Type::ITEM)
+		return (m_category == object.m_category);
+
+	if (m_type == Enigma::Object::Type::TELEPORTER)
+	{
+		return ((m_surface_arrival == object.m_surface_arrival)
+		        && (m_rotation_arrival == object.m_rotation_arrival)
+		        && (m_position_arrival.m_above == object.m_position_arrival.m_above)
+		        && (m_position_arrival.m_north == object.m_position_arrival.m_north)
+		        && (m_position_arrival.m_east == object.m_position_arrival.m_east));
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------
+// This method returns a hash of the object.  Objects that are the
+// same (see operator==) have the same hash.
+//-------------------------------------------------------------------
+// RETURN: 64-bit hash value.
+//-------------------------------------------------------------------
+
+guint64 Enigma::Object::hash() const
+{
+	Enigma::Hash hash;
+
+	hash.add((guint64)m_type);
+	hash.add((guint64)m_id);
+	hash.add((guint64)m_position.m_above);
+	hash.add((guint64)m_position.m_north);
+	hash.add((guint64)m_position.m_east);
+	hash.add((guint64)m_surface);
+	hash.add((guint64)m_rotation);
+	hash.add(m_sense);
+	hash.add(m_state);
+	hash.add(m_visibility);
+	hash.add(m_presence);
+
+	if (m_type == Enigma::Object::Type::PLAYER)
+		hash.add((guint64)m_active);
+	else if (m_type == Enigma::Object::Type::ITEM)
+		hash.add((guint64)m_category);
+	else if (m_type == Enigma::Object::Type::TELEPORTER)
+	{
+		hash.add((guint64)m_surface_arrival);
+		hash.add((guint64)m_rotation_arrival);
+		hash.add((guint64)m_position_arrival.m_above);
+		hash.add((guint64)m_position_arrival.m_north);
+		hash.add((guint64)m_position_arrival.m_east);
+	}
+
+	return hash.get();
+}
@@ -147,6 +147,8 @@ namespace Enigma
 			// Public methods.
 
 			void get_description(Glib::ustring& description);
+			bool operator==(const Enigma::Object& object) const;
+			guint64 hash() const;
 
 			// Public data.
 
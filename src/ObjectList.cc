@@ -29,6 +29,8 @@ Enigma::ObjectList::ObjectList()
 	// Initialize the cached list iterator.
 
 	m_iterator = end();
+	m_sorted   = true;
+	m_hash     = 0;
 }
 
 //-----------------------------
@@ -41,6 +43,8 @@ void Enigma::ObjectList::clear()
 
 	std::list<Enigma::Object>::clear();
 	m_iterator = end();
+	m_sorted   = true;
+	m_hash     = 0;
 }
 
 //-----------------------------------------------------------------
@@ -90,6 +94,34 @@ void Enigma::ObjectList::seek(const Enigma::Position& position)
 		}
 }
 
+//-----------------------------------------------------------------
+// This method moves the list iterator to the first object whose
+// position is the one provided or follows it.  If none exist, the
+// iterator will point past the end of the list.
+//-----------------------------------------------------------------
+// position: World position to seek.
+//-----------------------------------------------------------------
+
+void Enigma::ObjectList::seek_first(const Enigma::Position& position)
+{
+	seek(position);
+
+	// Move the list iterator back over any objects at the position.
+
+	while (m_iterator != begin())
+	{
+		m_iterator --;
+
+		if (((*m_iterator).m_position.m_above != position.m_above)
+		    || ((*m_iterator).m_position.m_north != position.m_north)
+		    || ((*m_iterator).m_position.m_east != position.m_east))
+		{
+			m_iterator ++;
+			break;
+		}
+	}
+}
+
 //-----------------------------------------------------
 // This method removes a list of objects.
 //-----------------------------------------------------
@@ -116,6 +148,8 @@ void Enigma::ObjectList::remove(
       if (m_iterator == *object)
         ++ m_iterator;
 
+      m_hash -= (*(*object)).hash();
+
       // Move the object to the end of the buffer.
 
       buffer.splice(buffer.end(), *this, *object);
@@ -135,7 +169,10 @@ void Enigma::ObjectList::erase(std::list<Enigma::Object>::iterator& object)
   // to erase the object. 
   
   if (object != end())
+  {
+    m_hash -= (*object).hash();
     m_iterator = std::list<Enigma::Object>::erase(object);
+  }
 }
 
 //-----------------------------------------------------------------
@@ -154,6 +191,7 @@ void Enigma::ObjectList::insert(Enigma::Object& object)
 	// before the insertion point.
 	
 	m_iterator = std::list<Enigma::Object>::insert(m_iterator, object);
+	m_hash += object.hash();
 }
 
 //--------------------------------------------------------------
@@ -175,9 +213,132 @@ void Enigma::ObjectList::insert(std::list<Enigma::Object>& buffer)
 	}
 }
 
+//---------------------------------------------------------------
+// This private function returns TRUE if the first object belongs
+// before the second object in a sorted list.
+//---------------------------------------------------------------
+// first:  First object.
+// second: Second object.
+// RETURN: TRUE if the first object is to be sorted first.
+//---------------------------------------------------------------
+
+bool compare_position(const Enigma::Object& first,
+                      const Enigma::Object& second)
+{
+	if (first.m_position.m_above != second.m_position.m_above)
+		return (first.m_position.m_above < second.m_position.m_above);
+
+	if (first.m_position.m_north != second.m_position.m_north)
+		return (first.m_position.m_north < second.m_position.m_north);
+
+	return (first.m_position.m_east < second.m_position.m_east);
+}
+
+//-------------------------------------------------------------------
+// This method moves all objects from a sorted buffer into the list.
+// It is much faster than inserting the objects one at a time, since
+// both lists are traversed only once.
+//-------------------------------------------------------------------
+// buffer: Sorted list of world objects to be moved.
+//-------------------------------------------------------------------
+
+void Enigma::ObjectList::merge(std::list<Enigma::Object>& buffer)
+{
+	// If all buffer objects belong after the list objects (such as when
+	// levels are loaded in ascending order), move them directly to the end.
+	// Otherwise, call the parent merge() method.  Objects are moved without
+	// being copied, so the cached iterator remains valid.
+
+	std::list<Enigma::Object>::iterator object;
+
+	for (object = buffer.begin(); object != buffer.end(); ++ object)
+		m_hash += (*object).hash();
+
+	if (empty() || buffer.empty() || !compare_position(buffer.front(), back()))
+		splice(end(), buffer);
+	else
+		std::list<Enigma::Object>::merge(buffer, compare_position);
+}
+
+//---------------------------------------------------------------------
+// This method moves all objects from another list to the end of this
+// list, without sorting them.  Whether this list remains sorted is
+// noted, so that sort() can correct it afterwards.
+//---------------------------------------------------------------------
+// list: List of world objects to be moved.
+//---------------------------------------------------------------------
+
+void Enigma::ObjectList::append(Enigma::ObjectList& list)
+{
+	if (list.empty())
+		return;
+
+	if (!list.m_sorted || (!empty() && compare_position(list.front(), back())))
+		m_sorted = false;
+
+	m_hash += list.m_hash;
+	splice(end(), list);
+	list.clear();
+}
+
+//-------------------------------------------------------------------
+// This method appends a copy of an object to the end of the list
+// without sorting it, which is much faster than inserting it when
+// objects arrive already sorted (such as when loading a world file).
+// An object out of order is noted, so that sort() can correct the
+// list afterwards.
+//-------------------------------------------------------------------
+// object: Object to be appended.
+//-------------------------------------------------------------------
+
+void Enigma::ObjectList::push_back(const Enigma::Object& object)
+{
+	if (!empty() && compare_position(object, back()))
+		m_sorted = false;
+
+	std::list<Enigma::Object>::push_back(object);
+	m_hash += object.hash();
+}
+
+//-------------------------------------------------------------------
+// This method sorts the list if any objects were appended out of
+// order.  Objects with the same position keep their original order.
+//-------------------------------------------------------------------
+// RETURN: TRUE if the list needed sorting.
+//-------------------------------------------------------------------
+
+bool Enigma::ObjectList::sort()
+{
+	if (m_sorted)
+		return false;
+
+	std::list<Enigma::Object>::sort(compare_position);
+
+	m_iterator = end();
+	m_sorted   = true;
+	return true;
+}
+
+//-------------------------------------------------------------------
+// This method returns a hash of the objects in the list.  Object
+// hashes are added together as objects are inserted and subtracted
+// as they are removed, so the hash is always current.  Adding rather
+// than XOR-ing keeps identical objects from cancelling each other.
+//-------------------------------------------------------------------
+// RETURN: 64-bit hash value, which does not depend on object order.
+//-------------------------------------------------------------------
+
+guint64 Enigma::ObjectList::hash() const
+{
+	return m_hash;
+}
+
 //-------------------------------------------------------------------
 // This method copies object iterators within a world volume into
-// a buffer.  The objects in the buffer will most likely be unsorted.
+// a buffer.  The sorted list is walked once from the volume's first
+// room to its last, seeking past the rooms of each level and row that
+// lie outside the volume, so reading a whole level costs no more than
+// the objects on it.  The objects in the buffer will be sorted.
 //-------------------------------------------------------------------
 // volume: World volume to be copied.
 // buffer: Buffer to receive copies of object iterators.
@@ -187,22 +348,57 @@ void Enigma::ObjectList::read(
 	Enigma::Volume& volume,
   std::list<std::list<Enigma::Object>::iterator>& buffer)
 {
-	Enigma::Position position;
+	Enigma::Position position = volume.m_WSB;
 
-	for (position.m_above = volume.m_WSB.m_above;
-	     position.m_above <= volume.m_ENA.m_above;
-	     ++ position.m_above )
+	seek_first(position);
+
+	while (m_iterator != end())
 	{
-		for (position.m_north = volume.m_WSB.m_north;
-		     position.m_north <= volume.m_ENA.m_north;
-		     ++ position.m_north )
+		const Enigma::Position& found = (*m_iterator).m_position;
+
+		position.m_above = found.m_above;
+		position.m_north = found.m_north;
+		position.m_east  = volume.m_WSB.m_east;
+
+		if (found.m_above > volume.m_ENA.m_above)
+			break;
+		else if (found.m_north < volume.m_WSB.m_north)
 		{
-			for (position.m_east = volume.m_WSB.m_east;
-			     position.m_east <= volume.m_ENA.m_east;
-			     ++ position.m_east )
-			{
-				read(position, buffer);
-			}
+			// Seek the volume's first row on this level.
+
+			position.m_north = volume.m_WSB.m_north;
+			seek_first(position);
+		}
+		else if ((found.m_north > volume.m_ENA.m_north)
+		         || ((found.m_north == volume.m_ENA.m_north)
+		             && (found.m_east > volume.m_ENA.m_east)))
+		{
+			// Seek the volume's first row on the next level.
+
+			if (found.m_above == volume.m_ENA.m_above)
+				break;
+
+			position.m_above = found.m_above + 1;
+			position.m_north = volume.m_WSB.m_north;
+			seek_first(position);
+		}
+		else if (found.m_east < volume.m_WSB.m_east)
+		{
+			// Seek the volume's first room in this row.
+
+			seek_first(position);
+		}
+		else if (found.m_east > volume.m_ENA.m_east)
+		{
+			// Seek the volume's first room in the next row.
+
+			position.m_north = found.m_north + 1;
+			seek_first(position);
+		}
+		else
+		{
+			buffer.push_back(m_iterator);
+			++ m_iterator;
 		}
 	}
 }
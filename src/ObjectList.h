@@ -36,6 +36,11 @@ namespace Enigma
 			void clear();
 			void insert(Enigma::Object& object);
 			void insert(std::list<Enigma::Object>& buffer);
+			void merge(std::list<Enigma::Object>& buffer);
+			void append(Enigma::ObjectList& list);
+			void push_back(const Enigma::Object& object);
+			bool sort();
+			guint64 hash() const;
 
 			void remove(std::list<std::list<Enigma::Object>::iterator>& objects,
 			            std::list<Enigma::Object>& buffer);
@@ -58,10 +63,13 @@ namespace Enigma
 			// Private methods.
 
 			void seek(const Enigma::Position& position);
+			void seek_first(const Enigma::Position& position);
 
 			// Private data.
 
 			std::list<Enigma::Object>::iterator m_iterator;  // Cached iterator.
+			bool m_sorted;                                   // TRUE if sorted.
+			guint64 m_hash;                                  // Sum of object hashes.
 	};
 }
 
@@ -0,0 +1,46 @@
+// "World in the Wine Cellar" world creator for "Enigma in the Wine Cellar".
+// Copyright (C) 2021 Chris Sterne <chris_sterne@hotmail.com>
+//
+// This file contains the RenderStats class header.  The RenderStats class
+// holds the measurements of one frame drawn by a level view.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  If not, see <http://www.gnu.org/licenses/>.
+ 
+#ifndef __RENDERSTATS_H__
+#define __RENDERSTATS_H__
+
+namespace Enigma
+{
+	class RenderStats
+	{
+		public:
+			// Public data.  Rooms drawn into the layer between frames, such as
+			// rooms changed by an edit, are counted in the next frame.
+
+			double m_query = 0;               // Seconds reading room objects.
+			double m_tiles = 0;               // Seconds drawing room tiles.
+			double m_overlay = 0;             // Seconds drawing marks and cursor.
+			double m_total = 0;               // Seconds drawing the frame.
+			unsigned int m_rooms = 0;         // Rooms read.
+			unsigned int m_environment = 0;   // Environment objects drawn.
+			unsigned int m_floor = 0;         // Floor objects drawn.
+			unsigned int m_objects = 0;       // Objects above floors drawn.
+			unsigned int m_stack_hits = 0;    // Stacks drawn from cached tiles.
+			unsigned int m_stack_misses = 0;  // Stacks composited or not cached.
+			unsigned int m_layer_redraws = 0; // Times whole layer was drawn.
+			unsigned int m_layer_scrolls = 0; // Times layer was scrolled.
+	};
+}
+
+#endif // __RENDERSTATS_H__
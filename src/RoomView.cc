@@ -187,6 +187,31 @@ bool Enigma::RoomView::on_key_press(GdkEventKey* key_event)
   return handled;
 }
 
+//----------------------------------------------------------------
+// This method updates the view if the room is at one of the
+// provided positions.
+//----------------------------------------------------------------
+// positions: Positions of changed rooms.
+//----------------------------------------------------------------
+
+void Enigma::RoomView::update(const std::list<Enigma::Position>& positions)
+{
+	std::list<Enigma::Position>::const_iterator position;
+
+	for (position = positions.begin();
+	     position != positions.end();
+	     ++ position)
+	{
+		if (((*position).m_above == m_position.m_above)
+		    && ((*position).m_north == m_position.m_north)
+		    && ((*position).m_east == m_position.m_east))
+		{
+			update();
+			return;
+		}
+	}
+}
+
 //------------------------------
 // This method updates the view.
 //------------------------------
@@ -202,6 +227,7 @@ void Enigma::RoomView::update()
 
   std::list<std::list<Enigma::Object>::iterator> buffer;
   
+  m_world->load_level(m_position.m_above);
   m_world->m_objects.read(m_position, buffer);
   m_world->m_teleporters.read(m_position, buffer);
   m_world->m_items.read(m_position, buffer);
@@ -38,6 +38,7 @@ namespace Enigma
 
 			RoomView();
 			void update();
+			void update(const std::list<Enigma::Position>& positions);
 			void set_world(std::shared_ptr<Enigma::World> world);
 			void set_position(const Enigma::Position& position);
 			bool on_key_press(GdkEventKey* key_event);
@@ -17,6 +17,12 @@
 // You should have received a copy of the GNU General Public License along
 // with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <giomm/resource.h>
 #include "Tiles.h"
 
 //--------------------
@@ -24,302 +30,822 @@
 //--------------------
 
 #define TILESIZE 60         // Pixel size of image tile.
-               
-//--------------------------------
-// This method is the constructor.
-//--------------------------------
-
-Enigma::Tiles::Tiles()
-{ 	
-	// Load image tiles from files.
-	
-	m_cursor =
-		Cairo::ImageSurface::create_from_png("./images/Cursor.png");
-
-	m_marker =
-		Cairo::ImageSurface::create_from_png("./images/Marker.png");
-
-	m_generic =
-		Cairo::ImageSurface::create_from_png("./images/Generic.png");
-
-	m_wall = 
-		Cairo::ImageSurface::create_from_png("./images/Wall.png");
-
-	m_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/Ceiling.png");
-
-	m_floor =
-		Cairo::ImageSurface::create_from_png("./images/Floor.png");
-
-	m_ladder =
-		Cairo::ImageSurface::create_from_png("./images/Ladder.png");
-
-	m_ladderend =
-		Cairo::ImageSurface::create_from_png("./images/LadderEnd.png");
-
-	m_ladderend_horizontal =
-		Cairo::ImageSurface::create_from_png("./images/LadderEndHorizontal.png");
-
-	m_ladderend_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/LadderEndCeiling.png");
+#define DETAILSIZE 10       // Smallest pixel size of drawn image tiles.
+#define STACKSMAX 2048      // Most composited stacks kept at one zoom level.
 
-	m_ladderend_floor =
-		Cairo::ImageSurface::create_from_png("./images/LadderEndFloor.png");
+// Pixel sizes of rooms at each zoom level.  Rooms smaller than DETAILSIZE
+// are drawn as blocks of colour.
 
-	m_ladder_horizontal =
-		Cairo::ImageSurface::create_from_png("./images/LadderHorizontal.png");
+static const int zoom_sizes[] = {60, 48, 40, 30, 24, 20, 15, 12, 10,
+                                 8, 6, 4, 3, 2, 1};
 
-	m_ladder_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/LadderCeiling.png");
+typedef Enigma::Object::ID ID;
+typedef Enigma::Object::Direction Direction;
+typedef Cairo::RefPtr<Cairo::ImageSurface> Enigma::TileSet::* TileImage;
 
-	m_ladder_floor =
-		Cairo::ImageSurface::create_from_png("./images/LadderFloor.png");
+static constexpr Direction ANY = Direction::TOTAL;  // Matches any direction.
 
-	m_player_active =
-		Cairo::ImageSurface::create_from_png("./images/PlayerActive.png");
+class TileRule                // Image tile drawn for matching objects.
+{
+	public:
+		ID m_id;                  // Object ID.
+		Direction m_surface;      // Object surface, or ANY.
+		Direction m_rotation;     // Object rotation, or ANY.
+		TileImage m_image;        // Image tile.
+		int m_angle;              // Image rotation (0, 90, 180, 270 degrees).
+};
+
+// Image tiles for object IDs.  The first rule matching an object's ID,
+// surface and rotation chooses its image.  Objects matching no rule are
+// not drawn.
+
+static constexpr TileRule tile_rules[] =
+{
+	// Stairs and StairsTop are drawn by rotation.
+	{ID::STAIRS,     ANY,               Direction::NORTH,  &Enigma::TileSet::m_stairs, 0},
+	{ID::STAIRS,     ANY,               Direction::SOUTH,  &Enigma::TileSet::m_stairs, 180},
+	{ID::STAIRS,     ANY,               Direction::EAST,   &Enigma::TileSet::m_stairs, 90},
+	{ID::STAIRS,     ANY,               Direction::WEST,   &Enigma::TileSet::m_stairs, 270},
+	{ID::STAIRSTOP,  ANY,               Direction::NORTH,  &Enigma::TileSet::m_stairstop, 0},
+	{ID::STAIRSTOP,  ANY,               Direction::SOUTH,  &Enigma::TileSet::m_stairstop, 180},
+	{ID::STAIRSTOP,  ANY,               Direction::EAST,   &Enigma::TileSet::m_stairstop, 90},
+	{ID::STAIRSTOP,  ANY,               Direction::WEST,   &Enigma::TileSet::m_stairstop, 270},
+
+	// Objects on walls, ceilings and floors are drawn by surface.
+	{ID::ARCHWAY,    Direction::NORTH,  ANY,               &Enigma::TileSet::m_archway_vertical, 0},
+	{ID::ARCHWAY,    Direction::SOUTH,  ANY,               &Enigma::TileSet::m_archway_vertical, 180},
+	{ID::ARCHWAY,    Direction::EAST,   ANY,               &Enigma::TileSet::m_archway_vertical, 90},
+	{ID::ARCHWAY,    Direction::WEST,   ANY,               &Enigma::TileSet::m_archway_vertical, 270},
+	{ID::ARCHWAY,    Direction::ABOVE,  ANY,               &Enigma::TileSet::m_archway_ceiling, 270},
+	{ID::ARCHWAY,    Direction::BELOW,  ANY,               &Enigma::TileSet::m_archway_floor, 270},
+	{ID::WOODDOOR,   Direction::NORTH,  ANY,               &Enigma::TileSet::m_wooddoor_vertical, 0},
+	{ID::WOODDOOR,   Direction::SOUTH,  ANY,               &Enigma::TileSet::m_wooddoor_vertical, 180},
+	{ID::WOODDOOR,   Direction::EAST,   ANY,               &Enigma::TileSet::m_wooddoor_vertical, 90},
+	{ID::WOODDOOR,   Direction::WEST,   ANY,               &Enigma::TileSet::m_wooddoor_vertical, 270},
+	{ID::WOODDOOR,   Direction::ABOVE,  ANY,               &Enigma::TileSet::m_wooddoor_ceiling, 270},
+	{ID::WOODDOOR,   Direction::BELOW,  ANY,               &Enigma::TileSet::m_wooddoor_floor, 270},
+	{ID::PULLRING,   Direction::NORTH,  ANY,               &Enigma::TileSet::m_pullring_vertical, 0},
+	{ID::PULLRING,   Direction::SOUTH,  ANY,               &Enigma::TileSet::m_pullring_vertical, 180},
+	{ID::PULLRING,   Direction::EAST,   ANY,               &Enigma::TileSet::m_pullring_vertical, 90},
+	{ID::PULLRING,   Direction::WEST,   ANY,               &Enigma::TileSet::m_pullring_vertical, 270},
+	{ID::PULLRING,   Direction::ABOVE,  ANY,               &Enigma::TileSet::m_pullring_horizontal, 0},
+	{ID::PULLRING,   Direction::BELOW,  ANY,               &Enigma::TileSet::m_pullring_horizontal, 0},
+	{ID::CUBELOCK,   Direction::NORTH,  ANY,               &Enigma::TileSet::m_lock_vertical, 0},
+	{ID::CUBELOCK,   Direction::SOUTH,  ANY,               &Enigma::TileSet::m_lock_vertical, 180},
+	{ID::CUBELOCK,   Direction::EAST,   ANY,               &Enigma::TileSet::m_lock_vertical, 90},
+	{ID::CUBELOCK,   Direction::WEST,   ANY,               &Enigma::TileSet::m_lock_vertical, 270},
+	{ID::CUBELOCK,   Direction::ABOVE,  ANY,               &Enigma::TileSet::m_lock_horizontal, 0},
+	{ID::CUBELOCK,   Direction::BELOW,  ANY,               &Enigma::TileSet::m_lock_horizontal, 0},
+	{ID::WATERLAYER, Direction::NORTH,  ANY,               &Enigma::TileSet::m_waterlayer_vertical, 0},
+	{ID::WATERLAYER, Direction::SOUTH,  ANY,               &Enigma::TileSet::m_waterlayer_vertical, 180},
+	{ID::WATERLAYER, Direction::EAST,   ANY,               &Enigma::TileSet::m_waterlayer_vertical, 90},
+	{ID::WATERLAYER, Direction::WEST,   ANY,               &Enigma::TileSet::m_waterlayer_vertical, 270},
+	{ID::WATERLAYER, Direction::ABOVE,  ANY,               &Enigma::TileSet::m_waterlayer_above, 0},
+	{ID::WATERLAYER, Direction::BELOW,  ANY,               &Enigma::TileSet::m_waterlayer_below, 0},
+	{ID::WATER,      ANY,               ANY,               &Enigma::TileSet::m_water, 0},
+	{ID::LIGHTBEAM,  Direction::NORTH,  ANY,               &Enigma::TileSet::m_lightbeam_horizontal, 0},
+	{ID::LIGHTBEAM,  Direction::SOUTH,  ANY,               &Enigma::TileSet::m_lightbeam_horizontal, 180},
+	{ID::LIGHTBEAM,  Direction::EAST,   ANY,               &Enigma::TileSet::m_lightbeam_horizontal, 90},
+	{ID::LIGHTBEAM,  Direction::WEST,   ANY,               &Enigma::TileSet::m_lightbeam_horizontal, 270},
+	{ID::LIGHTBEAM,  Direction::ABOVE,  ANY,               &Enigma::TileSet::m_lightbeam_vertical, 0},
+	{ID::LIGHTBEAM,  Direction::BELOW,  ANY,               &Enigma::TileSet::m_lightbeam_vertical, 0},
+	{ID::WOODWALL,   Direction::NORTH,  ANY,               &Enigma::TileSet::m_woodwall_vertical, 0},
+	{ID::WOODWALL,   Direction::SOUTH,  ANY,               &Enigma::TileSet::m_woodwall_vertical, 180},
+	{ID::WOODWALL,   Direction::EAST,   ANY,               &Enigma::TileSet::m_woodwall_vertical, 90},
+	{ID::WOODWALL,   Direction::WEST,   ANY,               &Enigma::TileSet::m_woodwall_vertical, 270},
+	{ID::WOODWALL,   Direction::ABOVE,  ANY,               &Enigma::TileSet::m_woodwall_ceiling, 0},
+	{ID::WOODWALL,   Direction::BELOW,  ANY,               &Enigma::TileSet::m_woodwall_floor, 0},
+	{ID::PADBUTTON,  Direction::NORTH,  ANY,               &Enigma::TileSet::m_padbutton_vertical, 0},
+	{ID::PADBUTTON,  Direction::SOUTH,  ANY,               &Enigma::TileSet::m_padbutton_vertical, 180},
+	{ID::PADBUTTON,  Direction::EAST,   ANY,               &Enigma::TileSet::m_padbutton_vertical, 90},
+	{ID::PADBUTTON,  Direction::WEST,   ANY,               &Enigma::TileSet::m_padbutton_vertical, 270},
+	{ID::PADBUTTON,  Direction::ABOVE,  ANY,               &Enigma::TileSet::m_padbutton_ceiling, 0},
+	{ID::PADBUTTON,  Direction::BELOW,  ANY,               &Enigma::TileSet::m_padbutton_floor, 0},
+	{ID::EARTHWALL,  Direction::NORTH,  ANY,               &Enigma::TileSet::m_earthwall_vertical, 0},
+	{ID::EARTHWALL,  Direction::SOUTH,  ANY,               &Enigma::TileSet::m_earthwall_vertical, 180},
+	{ID::EARTHWALL,  Direction::EAST,   ANY,               &Enigma::TileSet::m_earthwall_vertical, 90},
+	{ID::EARTHWALL,  Direction::WEST,   ANY,               &Enigma::TileSet::m_earthwall_vertical, 270},
+	{ID::EARTHWALL,  Direction::ABOVE,  ANY,               &Enigma::TileSet::m_earthwall_ceiling, 0},
+	{ID::EARTHWALL,  Direction::BELOW,  ANY,               &Enigma::TileSet::m_earthwall_floor, 0},
+	{ID::BLOCKWALL,  Direction::NORTH,  ANY,               &Enigma::TileSet::m_wall, 0},
+	{ID::BLOCKWALL,  Direction::SOUTH,  ANY,               &Enigma::TileSet::m_wall, 180},
+	{ID::BLOCKWALL,  Direction::EAST,   ANY,               &Enigma::TileSet::m_wall, 90},
+	{ID::BLOCKWALL,  Direction::WEST,   ANY,               &Enigma::TileSet::m_wall, 270},
+	{ID::BLOCKWALL,  Direction::ABOVE,  ANY,               &Enigma::TileSet::m_ceiling, 0},
+	{ID::BLOCKWALL,  Direction::BELOW,  ANY,               &Enigma::TileSet::m_floor, 0},
+	{ID::BLOCKER,    Direction::NORTH,  ANY,               &Enigma::TileSet::m_blocker, 0},
+	{ID::BLOCKER,    Direction::SOUTH,  ANY,               &Enigma::TileSet::m_blocker, 180},
+	{ID::BLOCKER,    Direction::EAST,   ANY,               &Enigma::TileSet::m_blocker, 90},
+	{ID::BLOCKER,    Direction::WEST,   ANY,               &Enigma::TileSet::m_blocker, 270},
+	{ID::BLOCKER,    Direction::ABOVE,  ANY,               &Enigma::TileSet::m_blocker_horizontal, 0},
+	{ID::BLOCKER,    Direction::BELOW,  ANY,               &Enigma::TileSet::m_blocker_horizontal, 0},
+	{ID::FLIPPER,    Direction::NORTH,  ANY,               &Enigma::TileSet::m_surfacer, 0},
+	{ID::FLIPPER,    Direction::SOUTH,  ANY,               &Enigma::TileSet::m_surfacer, 180},
+	{ID::FLIPPER,    Direction::EAST,   ANY,               &Enigma::TileSet::m_surfacer, 90},
+	{ID::FLIPPER,    Direction::WEST,   ANY,               &Enigma::TileSet::m_surfacer, 270},
+	{ID::FLIPPER,    Direction::ABOVE,  ANY,               &Enigma::TileSet::m_flipper, 0},
+	{ID::FLIPPER,    Direction::BELOW,  ANY,               &Enigma::TileSet::m_flipper, 0},
+
+	// A Surfacer on a wall is drawn as a corner when rotated sideways.
+	{ID::SURFACER,   Direction::ABOVE,  Direction::NORTH,  &Enigma::TileSet::m_surfacer, 0},
+	{ID::SURFACER,   Direction::ABOVE,  Direction::SOUTH,  &Enigma::TileSet::m_surfacer, 180},
+	{ID::SURFACER,   Direction::ABOVE,  Direction::EAST,   &Enigma::TileSet::m_surfacer, 90},
+	{ID::SURFACER,   Direction::ABOVE,  Direction::WEST,   &Enigma::TileSet::m_surfacer, 270},
+	{ID::SURFACER,   Direction::BELOW,  Direction::NORTH,  &Enigma::TileSet::m_surfacer, 0},
+	{ID::SURFACER,   Direction::BELOW,  Direction::SOUTH,  &Enigma::TileSet::m_surfacer, 180},
+	{ID::SURFACER,   Direction::BELOW,  Direction::EAST,   &Enigma::TileSet::m_surfacer, 90},
+	{ID::SURFACER,   Direction::BELOW,  Direction::WEST,   &Enigma::TileSet::m_surfacer, 270},
+	{ID::SURFACER,   Direction::NORTH,  Direction::WEST,   &Enigma::TileSet::m_surfacer_corner, 0},
+	{ID::SURFACER,   Direction::NORTH,  Direction::EAST,   &Enigma::TileSet::m_surfacer_corner, 90},
+	{ID::SURFACER,   Direction::NORTH,  ANY,               &Enigma::TileSet::m_surfacer, 0},
+	{ID::SURFACER,   Direction::SOUTH,  Direction::WEST,   &Enigma::TileSet::m_surfacer_corner, 270},
+	{ID::SURFACER,   Direction::SOUTH,  Direction::EAST,   &Enigma::TileSet::m_surfacer_corner, 180},
+	{ID::SURFACER,   Direction::SOUTH,  ANY,               &Enigma::TileSet::m_surfacer, 180},
+	{ID::SURFACER,   Direction::EAST,   Direction::NORTH,  &Enigma::TileSet::m_surfacer_corner, 90},
+	{ID::SURFACER,   Direction::EAST,   Direction::SOUTH,  &Enigma::TileSet::m_surfacer_corner, 180},
+	{ID::SURFACER,   Direction::EAST,   ANY,               &Enigma::TileSet::m_surfacer, 90},
+	{ID::SURFACER,   Direction::WEST,   Direction::NORTH,  &Enigma::TileSet::m_surfacer_corner, 0},
+	{ID::SURFACER,   Direction::WEST,   Direction::SOUTH,  &Enigma::TileSet::m_surfacer_corner, 270},
+	{ID::SURFACER,   Direction::WEST,   ANY,               &Enigma::TileSet::m_surfacer, 270},
+	{ID::MOVER,      ANY,               Direction::NORTH,  &Enigma::TileSet::m_mover, 0},
+	{ID::MOVER,      ANY,               Direction::SOUTH,  &Enigma::TileSet::m_mover, 180},
+	{ID::MOVER,      ANY,               Direction::EAST,   &Enigma::TileSet::m_mover, 90},
+	{ID::MOVER,      ANY,               Direction::WEST,   &Enigma::TileSet::m_mover, 270},
+	{ID::MOVER,      ANY,               Direction::ABOVE,  &Enigma::TileSet::m_mover_above, 0},
+	{ID::MOVER,      ANY,               Direction::BELOW,  &Enigma::TileSet::m_mover_below, 0},
+	{ID::TURNER,     ANY,               ANY,               &Enigma::TileSet::m_turner, 0},
+
+	// Ladders, CatWalks and Trees run along their rotation (Ladder, CatWalk)
+	// or grow out from their surface (Tree).
+	{ID::LADDER,     Direction::NORTH,  Direction::ABOVE,  &Enigma::TileSet::m_ladder, 0},
+	{ID::LADDER,     Direction::SOUTH,  Direction::ABOVE,  &Enigma::TileSet::m_ladder, 180},
+	{ID::LADDER,     Direction::EAST,   Direction::ABOVE,  &Enigma::TileSet::m_ladder, 90},
+	{ID::LADDER,     Direction::WEST,   Direction::ABOVE,  &Enigma::TileSet::m_ladder, 270},
+	{ID::LADDER,     Direction::NORTH,  Direction::BELOW,  &Enigma::TileSet::m_ladder, 0},
+	{ID::LADDER,     Direction::SOUTH,  Direction::BELOW,  &Enigma::TileSet::m_ladder, 180},
+	{ID::LADDER,     Direction::EAST,   Direction::BELOW,  &Enigma::TileSet::m_ladder, 90},
+	{ID::LADDER,     Direction::WEST,   Direction::BELOW,  &Enigma::TileSet::m_ladder, 270},
+	{ID::LADDER,     Direction::ABOVE,  Direction::EAST,   &Enigma::TileSet::m_ladder_ceiling, 0},
+	{ID::LADDER,     Direction::BELOW,  Direction::EAST,   &Enigma::TileSet::m_ladder_floor, 0},
+	{ID::LADDER,     Direction::NORTH,  Direction::EAST,   &Enigma::TileSet::m_ladder_horizontal, 0},
+	{ID::LADDER,     Direction::SOUTH,  Direction::EAST,   &Enigma::TileSet::m_ladder_horizontal, 180},
+	{ID::LADDER,     Direction::ABOVE,  Direction::WEST,   &Enigma::TileSet::m_ladder_ceiling, 0},
+	{ID::LADDER,     Direction::BELOW,  Direction::WEST,   &Enigma::TileSet::m_ladder_floor, 0},
+	{ID::LADDER,     Direction::NORTH,  Direction::WEST,   &Enigma::TileSet::m_ladder_horizontal, 0},
+	{ID::LADDER,     Direction::SOUTH,  Direction::WEST,   &Enigma::TileSet::m_ladder_horizontal, 180},
+	{ID::LADDER,     Direction::ABOVE,  Direction::NORTH,  &Enigma::TileSet::m_ladder_floor, 90},
+	{ID::LADDER,     Direction::BELOW,  Direction::NORTH,  &Enigma::TileSet::m_ladder_ceiling, 90},
+	{ID::LADDER,     Direction::EAST,   Direction::NORTH,  &Enigma::TileSet::m_ladder_horizontal, 90},
+	{ID::LADDER,     Direction::WEST,   Direction::NORTH,  &Enigma::TileSet::m_ladder_horizontal, 270},
+	{ID::LADDER,     Direction::ABOVE,  Direction::SOUTH,  &Enigma::TileSet::m_ladder_floor, 90},
+	{ID::LADDER,     Direction::BELOW,  Direction::SOUTH,  &Enigma::TileSet::m_ladder_ceiling, 90},
+	{ID::LADDER,     Direction::EAST,   Direction::SOUTH,  &Enigma::TileSet::m_ladder_horizontal, 90},
+	{ID::LADDER,     Direction::WEST,   Direction::SOUTH,  &Enigma::TileSet::m_ladder_horizontal, 270},
+	{ID::LADDEREND,  Direction::NORTH,  Direction::ABOVE,  &Enigma::TileSet::m_ladderend, 0},
+	{ID::LADDEREND,  Direction::SOUTH,  Direction::ABOVE,  &Enigma::TileSet::m_ladderend, 180},
+	{ID::LADDEREND,  Direction::EAST,   Direction::ABOVE,  &Enigma::TileSet::m_ladderend, 90},
+	{ID::LADDEREND,  Direction::WEST,   Direction::ABOVE,  &Enigma::TileSet::m_ladderend, 270},
+	{ID::LADDEREND,  Direction::NORTH,  Direction::BELOW,  &Enigma::TileSet::m_ladderend, 0},
+	{ID::LADDEREND,  Direction::SOUTH,  Direction::BELOW,  &Enigma::TileSet::m_ladderend, 180},
+	{ID::LADDEREND,  Direction::EAST,   Direction::BELOW,  &Enigma::TileSet::m_ladderend, 90},
+	{ID::LADDEREND,  Direction::WEST,   Direction::BELOW,  &Enigma::TileSet::m_ladderend, 270},
+	{ID::LADDEREND,  Direction::NORTH,  Direction::WEST,   &Enigma::TileSet::m_ladderend_horizontal, 0},
+	{ID::LADDEREND,  Direction::SOUTH,  Direction::WEST,   &Enigma::TileSet::m_ladderend_horizontal, 270},
+	{ID::LADDEREND,  Direction::ABOVE,  Direction::WEST,   &Enigma::TileSet::m_ladderend_ceiling, 0},
+	{ID::LADDEREND,  Direction::BELOW,  Direction::WEST,   &Enigma::TileSet::m_ladderend_floor, 0},
+	{ID::LADDEREND,  Direction::NORTH,  Direction::EAST,   &Enigma::TileSet::m_ladderend_horizontal, 90},
+	{ID::LADDEREND,  Direction::SOUTH,  Direction::EAST,   &Enigma::TileSet::m_ladderend_horizontal, 180},
+	{ID::LADDEREND,  Direction::ABOVE,  Direction::EAST,   &Enigma::TileSet::m_ladderend_ceiling, 180},
+	{ID::LADDEREND,  Direction::BELOW,  Direction::EAST,   &Enigma::TileSet::m_ladderend_floor, 180},
+	{ID::LADDEREND,  Direction::WEST,   Direction::NORTH,  &Enigma::TileSet::m_ladderend_horizontal, 0},
+	{ID::LADDEREND,  Direction::EAST,   Direction::NORTH,  &Enigma::TileSet::m_ladderend_horizontal, 90},
+	{ID::LADDEREND,  Direction::ABOVE,  Direction::NORTH,  &Enigma::TileSet::m_ladderend_floor, 90},
+	{ID::LADDEREND,  Direction::BELOW,  Direction::NORTH,  &Enigma::TileSet::m_ladderend_ceiling, 90},
+	{ID::LADDEREND,  Direction::WEST,   Direction::SOUTH,  &Enigma::TileSet::m_ladderend_horizontal, 270},
+	{ID::LADDEREND,  Direction::EAST,   Direction::SOUTH,  &Enigma::TileSet::m_ladderend_horizontal, 180},
+	{ID::LADDEREND,  Direction::ABOVE,  Direction::SOUTH,  &Enigma::TileSet::m_ladderend_floor, 270},
+	{ID::LADDEREND,  Direction::BELOW,  Direction::SOUTH,  &Enigma::TileSet::m_ladderend_ceiling, 270},
+	{ID::TREE,       Direction::ABOVE,  Direction::NORTH,  &Enigma::TileSet::m_tree, 0},
+	{ID::TREE,       Direction::ABOVE,  Direction::SOUTH,  &Enigma::TileSet::m_tree, 180},
+	{ID::TREE,       Direction::ABOVE,  Direction::EAST,   &Enigma::TileSet::m_tree, 90},
+	{ID::TREE,       Direction::ABOVE,  Direction::WEST,   &Enigma::TileSet::m_tree, 270},
+	{ID::TREE,       Direction::BELOW,  Direction::NORTH,  &Enigma::TileSet::m_tree, 0},
+	{ID::TREE,       Direction::BELOW,  Direction::SOUTH,  &Enigma::TileSet::m_tree, 180},
+	{ID::TREE,       Direction::BELOW,  Direction::EAST,   &Enigma::TileSet::m_tree, 90},
+	{ID::TREE,       Direction::BELOW,  Direction::WEST,   &Enigma::TileSet::m_tree, 270},
+	{ID::TREE,       Direction::EAST,   Direction::ABOVE,  &Enigma::TileSet::m_tree_ceiling, 0},
+	{ID::TREE,       Direction::EAST,   Direction::BELOW,  &Enigma::TileSet::m_tree_floor, 0},
+	{ID::TREE,       Direction::EAST,   Direction::NORTH,  &Enigma::TileSet::m_tree_horizontal, 0},
+	{ID::TREE,       Direction::EAST,   Direction::SOUTH,  &Enigma::TileSet::m_tree_horizontal, 180},
+	{ID::TREE,       Direction::WEST,   Direction::ABOVE,  &Enigma::TileSet::m_tree_ceiling, 0},
+	{ID::TREE,       Direction::WEST,   Direction::BELOW,  &Enigma::TileSet::m_tree_floor, 0},
+	{ID::TREE,       Direction::WEST,   Direction::NORTH,  &Enigma::TileSet::m_tree_horizontal, 0},
+	{ID::TREE,       Direction::WEST,   Direction::SOUTH,  &Enigma::TileSet::m_tree_horizontal, 180},
+	{ID::TREE,       Direction::NORTH,  Direction::ABOVE,  &Enigma::TileSet::m_tree_floor, 90},
+	{ID::TREE,       Direction::NORTH,  Direction::BELOW,  &Enigma::TileSet::m_tree_ceiling, 90},
+	{ID::TREE,       Direction::NORTH,  Direction::EAST,   &Enigma::TileSet::m_tree_horizontal, 90},
+	{ID::TREE,       Direction::NORTH,  Direction::WEST,   &Enigma::TileSet::m_tree_horizontal, 270},
+	{ID::TREE,       Direction::SOUTH,  Direction::ABOVE,  &Enigma::TileSet::m_tree_floor, 90},
+	{ID::TREE,       Direction::SOUTH,  Direction::BELOW,  &Enigma::TileSet::m_tree_ceiling, 90},
+	{ID::TREE,       Direction::SOUTH,  Direction::EAST,   &Enigma::TileSet::m_tree_horizontal, 90},
+	{ID::TREE,       Direction::SOUTH,  Direction::WEST,   &Enigma::TileSet::m_tree_horizontal, 270},
+	{ID::TREETOP,    Direction::ABOVE,  Direction::NORTH,  &Enigma::TileSet::m_treetop, 0},
+	{ID::TREETOP,    Direction::ABOVE,  Direction::SOUTH,  &Enigma::TileSet::m_treetop, 180},
+	{ID::TREETOP,    Direction::ABOVE,  Direction::EAST,   &Enigma::TileSet::m_treetop, 90},
+	{ID::TREETOP,    Direction::ABOVE,  Direction::WEST,   &Enigma::TileSet::m_treetop, 270},
+	{ID::TREETOP,    Direction::BELOW,  Direction::NORTH,  &Enigma::TileSet::m_treetop, 0},
+	{ID::TREETOP,    Direction::BELOW,  Direction::SOUTH,  &Enigma::TileSet::m_treetop, 180},
+	{ID::TREETOP,    Direction::BELOW,  Direction::EAST,   &Enigma::TileSet::m_treetop, 90},
+	{ID::TREETOP,    Direction::BELOW,  Direction::WEST,   &Enigma::TileSet::m_treetop, 270},
+	{ID::TREETOP,    Direction::WEST,   Direction::NORTH,  &Enigma::TileSet::m_treetop_horizontal, 0},
+	{ID::TREETOP,    Direction::WEST,   Direction::SOUTH,  &Enigma::TileSet::m_treetop_horizontal, 270},
+	{ID::TREETOP,    Direction::WEST,   Direction::ABOVE,  &Enigma::TileSet::m_treetop_ceiling, 0},
+	{ID::TREETOP,    Direction::WEST,   Direction::BELOW,  &Enigma::TileSet::m_treetop_floor, 0},
+	{ID::TREETOP,    Direction::EAST,   Direction::NORTH,  &Enigma::TileSet::m_treetop_horizontal, 90},
+	{ID::TREETOP,    Direction::EAST,   Direction::SOUTH,  &Enigma::TileSet::m_treetop_horizontal, 180},
+	{ID::TREETOP,    Direction::EAST,   Direction::ABOVE,  &Enigma::TileSet::m_treetop_ceiling, 180},
+	{ID::TREETOP,    Direction::EAST,   Direction::BELOW,  &Enigma::TileSet::m_treetop_floor, 180},
+	{ID::TREETOP,    Direction::NORTH,  Direction::WEST,   &Enigma::TileSet::m_treetop_horizontal, 0},
+	{ID::TREETOP,    Direction::NORTH,  Direction::EAST,   &Enigma::TileSet::m_treetop_horizontal, 90},
+	{ID::TREETOP,    Direction::NORTH,  Direction::ABOVE,  &Enigma::TileSet::m_treetop_floor, 90},
+	{ID::TREETOP,    Direction::NORTH,  Direction::BELOW,  &Enigma::TileSet::m_treetop_ceiling, 90},
+	{ID::TREETOP,    Direction::SOUTH,  Direction::WEST,   &Enigma::TileSet::m_treetop_horizontal, 270},
+	{ID::TREETOP,    Direction::SOUTH,  Direction::EAST,   &Enigma::TileSet::m_treetop_horizontal, 180},
+	{ID::TREETOP,    Direction::SOUTH,  Direction::ABOVE,  &Enigma::TileSet::m_treetop_floor, 270},
+	{ID::TREETOP,    Direction::SOUTH,  Direction::BELOW,  &Enigma::TileSet::m_treetop_ceiling, 270},
+	{ID::CATWALK,    Direction::NORTH,  Direction::ABOVE,  &Enigma::TileSet::m_catwalk_vertical, 0},
+	{ID::CATWALK,    Direction::SOUTH,  Direction::ABOVE,  &Enigma::TileSet::m_catwalk_vertical, 180},
+	{ID::CATWALK,    Direction::EAST,   Direction::ABOVE,  &Enigma::TileSet::m_catwalk_vertical, 90},
+	{ID::CATWALK,    Direction::WEST,   Direction::ABOVE,  &Enigma::TileSet::m_catwalk_vertical, 270},
+	{ID::CATWALK,    Direction::NORTH,  Direction::BELOW,  &Enigma::TileSet::m_catwalk_vertical, 0},
+	{ID::CATWALK,    Direction::SOUTH,  Direction::BELOW,  &Enigma::TileSet::m_catwalk_vertical, 180},
+	{ID::CATWALK,    Direction::EAST,   Direction::BELOW,  &Enigma::TileSet::m_catwalk_vertical, 90},
+	{ID::CATWALK,    Direction::WEST,   Direction::BELOW,  &Enigma::TileSet::m_catwalk_vertical, 270},
+	{ID::CATWALK,    Direction::ABOVE,  Direction::EAST,   &Enigma::TileSet::m_catwalk_ceiling, 0},
+	{ID::CATWALK,    Direction::BELOW,  Direction::EAST,   &Enigma::TileSet::m_catwalk_floor, 0},
+	{ID::CATWALK,    Direction::NORTH,  Direction::EAST,   &Enigma::TileSet::m_catwalk_horizontal, 0},
+	{ID::CATWALK,    Direction::SOUTH,  Direction::EAST,   &Enigma::TileSet::m_catwalk_horizontal, 180},
+	{ID::CATWALK,    Direction::ABOVE,  Direction::WEST,   &Enigma::TileSet::m_catwalk_ceiling, 0},
+	{ID::CATWALK,    Direction::BELOW,  Direction::WEST,   &Enigma::TileSet::m_catwalk_floor, 0},
+	{ID::CATWALK,    Direction::NORTH,  Direction::WEST,   &Enigma::TileSet::m_catwalk_horizontal, 0},
+	{ID::CATWALK,    Direction::SOUTH,  Direction::WEST,   &Enigma::TileSet::m_catwalk_horizontal, 180},
+	{ID::CATWALK,    Direction::ABOVE,  Direction::NORTH,  &Enigma::TileSet::m_catwalk_floor, 90},
+	{ID::CATWALK,    Direction::BELOW,  Direction::NORTH,  &Enigma::TileSet::m_catwalk_ceiling, 90},
+	{ID::CATWALK,    Direction::EAST,   Direction::NORTH,  &Enigma::TileSet::m_catwalk_horizontal, 90},
+	{ID::CATWALK,    Direction::WEST,   Direction::NORTH,  &Enigma::TileSet::m_catwalk_horizontal, 270},
+	{ID::CATWALK,    Direction::ABOVE,  Direction::SOUTH,  &Enigma::TileSet::m_catwalk_floor, 90},
+	{ID::CATWALK,    Direction::BELOW,  Direction::SOUTH,  &Enigma::TileSet::m_catwalk_ceiling, 90},
+	{ID::CATWALK,    Direction::EAST,   Direction::SOUTH,  &Enigma::TileSet::m_catwalk_horizontal, 90},
+	{ID::CATWALK,    Direction::WEST,   Direction::SOUTH,  &Enigma::TileSet::m_catwalk_horizontal, 270},
+
+	// A Fern grows out from a wall onto the floor.
+	{ID::FERN,       Direction::NORTH,  Direction::BELOW,  &Enigma::TileSet::m_fern_floor, 0},
+	{ID::FERN,       Direction::EAST,   Direction::BELOW,  &Enigma::TileSet::m_fern_floor, 90},
+	{ID::FERN,       Direction::SOUTH,  Direction::BELOW,  &Enigma::TileSet::m_fern_floor, 180},
+	{ID::FERN,       Direction::WEST,   Direction::BELOW,  &Enigma::TileSet::m_fern_floor, 270},
+
+	// A HandHold is drawn where its surface and rotation meet.
+	{ID::HANDHOLD,   Direction::ABOVE,  Direction::NORTH,  &Enigma::TileSet::m_handhold, 0},
+	{ID::HANDHOLD,   Direction::BELOW,  Direction::NORTH,  &Enigma::TileSet::m_handhold, 0},
+	{ID::HANDHOLD,   Direction::NORTH,  Direction::ABOVE,  &Enigma::TileSet::m_handhold, 0},
+	{ID::HANDHOLD,   Direction::NORTH,  Direction::BELOW,  &Enigma::TileSet::m_handhold, 0},
+	{ID::HANDHOLD,   Direction::ABOVE,  Direction::EAST,   &Enigma::TileSet::m_handhold, 90},
+	{ID::HANDHOLD,   Direction::BELOW,  Direction::EAST,   &Enigma::TileSet::m_handhold, 90},
+	{ID::HANDHOLD,   Direction::EAST,   Direction::ABOVE,  &Enigma::TileSet::m_handhold, 90},
+	{ID::HANDHOLD,   Direction::EAST,   Direction::BELOW,  &Enigma::TileSet::m_handhold, 90},
+	{ID::HANDHOLD,   Direction::ABOVE,  Direction::SOUTH,  &Enigma::TileSet::m_handhold, 180},
+	{ID::HANDHOLD,   Direction::BELOW,  Direction::SOUTH,  &Enigma::TileSet::m_handhold, 180},
+	{ID::HANDHOLD,   Direction::SOUTH,  Direction::ABOVE,  &Enigma::TileSet::m_handhold, 180},
+	{ID::HANDHOLD,   Direction::SOUTH,  Direction::BELOW,  &Enigma::TileSet::m_handhold, 180},
+	{ID::HANDHOLD,   Direction::ABOVE,  Direction::WEST,   &Enigma::TileSet::m_handhold, 270},
+	{ID::HANDHOLD,   Direction::BELOW,  Direction::WEST,   &Enigma::TileSet::m_handhold, 270},
+	{ID::HANDHOLD,   Direction::WEST,   Direction::ABOVE,  &Enigma::TileSet::m_handhold, 270},
+	{ID::HANDHOLD,   Direction::WEST,   Direction::BELOW,  &Enigma::TileSet::m_handhold, 270},
+	{ID::HANDHOLD,   Direction::NORTH,  Direction::WEST,   &Enigma::TileSet::m_handhold_horizontal, 0},
+	{ID::HANDHOLD,   Direction::WEST,   Direction::NORTH,  &Enigma::TileSet::m_handhold_horizontal, 0},
+	{ID::HANDHOLD,   Direction::EAST,   Direction::NORTH,  &Enigma::TileSet::m_handhold_horizontal, 90},
+	{ID::HANDHOLD,   Direction::NORTH,  Direction::EAST,   &Enigma::TileSet::m_handhold_horizontal, 90},
+	{ID::HANDHOLD,   Direction::SOUTH,  Direction::EAST,   &Enigma::TileSet::m_handhold_horizontal, 180},
+	{ID::HANDHOLD,   Direction::EAST,   Direction::SOUTH,  &Enigma::TileSet::m_handhold_horizontal, 180},
+	{ID::HANDHOLD,   Direction::WEST,   Direction::SOUTH,  &Enigma::TileSet::m_handhold_horizontal, 270},
+	{ID::HANDHOLD,   Direction::SOUTH,  Direction::WEST,   &Enigma::TileSet::m_handhold_horizontal, 270},
+
+	// Environments are drawn by surface, or filling the room (Center).
+	{ID::OUTDOOR,    Direction::NORTH,  ANY,               &Enigma::TileSet::m_outdoor_vertical, 0},
+	{ID::OUTDOOR,    Direction::SOUTH,  ANY,               &Enigma::TileSet::m_outdoor_vertical, 180},
+	{ID::OUTDOOR,    Direction::EAST,   ANY,               &Enigma::TileSet::m_outdoor_vertical, 90},
+	{ID::OUTDOOR,    Direction::WEST,   ANY,               &Enigma::TileSet::m_outdoor_vertical, 270},
+	{ID::OUTDOOR,    Direction::ABOVE,  ANY,               &Enigma::TileSet::m_outdoor_ceiling, 0},
+	{ID::OUTDOOR,    Direction::BELOW,  ANY,               &Enigma::TileSet::m_outdoor_floor, 0},
+	{ID::OUTDOOR,    Direction::CENTER, ANY,               &Enigma::TileSet::m_outdoor, 0},
+	{ID::INDOOR,     Direction::NORTH,  ANY,               &Enigma::TileSet::m_indoor_vertical, 0},
+	{ID::INDOOR,     Direction::SOUTH,  ANY,               &Enigma::TileSet::m_indoor_vertical, 180},
+	{ID::INDOOR,     Direction::EAST,   ANY,               &Enigma::TileSet::m_indoor_vertical, 90},
+	{ID::INDOOR,     Direction::WEST,   ANY,               &Enigma::TileSet::m_indoor_vertical, 270},
+	{ID::INDOOR,     Direction::ABOVE,  ANY,               &Enigma::TileSet::m_indoor_ceiling, 0},
+	{ID::INDOOR,     Direction::BELOW,  ANY,               &Enigma::TileSet::m_indoor_floor, 0},
+	{ID::INDOOR,     Direction::CENTER, ANY,               &Enigma::TileSet::m_indoor, 0},
+};
+
+// Object IDs drawn with the same image tiles as another ID.
+
+static constexpr ID tile_aliases[][2] =
+{
+	{ID::STONEWALL,  ID::BLOCKWALL},
+	{ID::SPHERELOCK, ID::CUBELOCK},
+	{ID::WATERLOCK,  ID::CUBELOCK},
+	{ID::APPLELOCK,  ID::CUBELOCK},
+	{ID::ORANGELOCK, ID::CUBELOCK},
+	{ID::WINELOCK,   ID::CUBELOCK},
+	{ID::EDGER,      ID::SURFACER}
+};
+               
+class TileFile                // Image tile and its file in the resource bundle.
+{
+	public:
+		TileImage m_image;        // Image tile.
+		const char* m_filename;   // PNG image file.
+};
 
-	m_player_idle =
-		Cairo::ImageSurface::create_from_png("./images/PlayerIdle.png");
+// Image tile files, found in the "images/" folder of the resource bundle.
 
-	m_blocker =
-		Cairo::ImageSurface::create_from_png("./images/Blocker.png");
+static constexpr TileFile tile_files[] =
+{
+	{&Enigma::TileSet::m_cursor,               "Cursor.png"},
+	{&Enigma::TileSet::m_marker,               "Marker.png"},
+	{&Enigma::TileSet::m_generic,              "Generic.png"},
+	{&Enigma::TileSet::m_wall,                 "Wall.png"},
+	{&Enigma::TileSet::m_ceiling,              "Ceiling.png"},
+	{&Enigma::TileSet::m_floor,                "Floor.png"},
+	{&Enigma::TileSet::m_ladder,               "Ladder.png"},
+	{&Enigma::TileSet::m_ladderend,            "LadderEnd.png"},
+	{&Enigma::TileSet::m_ladderend_horizontal, "LadderEndHorizontal.png"},
+	{&Enigma::TileSet::m_ladderend_ceiling,    "LadderEndCeiling.png"},
+	{&Enigma::TileSet::m_ladderend_floor,      "LadderEndFloor.png"},
+	{&Enigma::TileSet::m_ladder_horizontal,    "LadderHorizontal.png"},
+	{&Enigma::TileSet::m_ladder_ceiling,       "LadderCeiling.png"},
+	{&Enigma::TileSet::m_ladder_floor,         "LadderFloor.png"},
+	{&Enigma::TileSet::m_player_active,        "PlayerActive.png"},
+	{&Enigma::TileSet::m_player_idle,          "PlayerIdle.png"},
+	{&Enigma::TileSet::m_blocker,              "Blocker.png"},
+	{&Enigma::TileSet::m_blocker_horizontal,   "BlockerHorizontal.png"},
+	{&Enigma::TileSet::m_mover,                "Mover.png"},
+	{&Enigma::TileSet::m_mover_below,          "MoverBelow.png"},
+	{&Enigma::TileSet::m_mover_above,          "MoverAbove.png"},
+	{&Enigma::TileSet::m_turner,               "Turner.png"},
+	{&Enigma::TileSet::m_item,                 "Item.png"},
+	{&Enigma::TileSet::m_flipper,              "Flipper.png"},
+	{&Enigma::TileSet::m_surfacer,             "Surfacer.png"},
+	{&Enigma::TileSet::m_surfacer_corner,      "SurfacerCorner.png"},
+	{&Enigma::TileSet::m_stairs,               "Stairs.png"},
+	{&Enigma::TileSet::m_stairstop,            "StairsTop.png"},
+	{&Enigma::TileSet::m_handhold,             "HandHold.png"},
+	{&Enigma::TileSet::m_handhold_horizontal,  "HandHoldHorizontal.png"},
+	{&Enigma::TileSet::m_outdoor,              "Outdoor.png"},
+	{&Enigma::TileSet::m_outdoor_vertical,     "OutdoorVertical.png"},
+	{&Enigma::TileSet::m_outdoor_ceiling,      "OutdoorCeiling.png"},
+	{&Enigma::TileSet::m_outdoor_floor,        "OutdoorFloor.png"},
+	{&Enigma::TileSet::m_indoor,               "Indoor.png"},
+	{&Enigma::TileSet::m_indoor_vertical,      "IndoorVertical.png"},
+	{&Enigma::TileSet::m_indoor_ceiling,       "IndoorCeiling.png"},
+	{&Enigma::TileSet::m_indoor_floor,         "IndoorFloor.png"},
+	{&Enigma::TileSet::m_archway_vertical,     "ArchWayVertical.png"},
+	{&Enigma::TileSet::m_archway_ceiling,      "ArchWayCeiling.png"},
+	{&Enigma::TileSet::m_archway_floor,        "ArchWayFloor.png"},
+	{&Enigma::TileSet::m_wooddoor_vertical,    "WoodDoorVertical.png"},
+	{&Enigma::TileSet::m_wooddoor_ceiling,     "WoodDoorCeiling.png"},
+	{&Enigma::TileSet::m_wooddoor_floor,       "WoodDoorFloor.png"},
+	{&Enigma::TileSet::m_woodwall_vertical,    "WoodWallVertical.png"},
+	{&Enigma::TileSet::m_woodwall_ceiling,     "WoodWallCeiling.png"},
+	{&Enigma::TileSet::m_woodwall_floor,       "WoodWallFloor.png"},
+	{&Enigma::TileSet::m_pullring_horizontal,  "PullRingHorizontal.png"},
+	{&Enigma::TileSet::m_pullring_vertical,    "PullRingVertical.png"},
+	{&Enigma::TileSet::m_lock_horizontal,      "LockHorizontal.png"},
+	{&Enigma::TileSet::m_lock_vertical,        "LockVertical.png"},
+	{&Enigma::TileSet::m_waterlayer_vertical,  "WaterLayerVertical.png"},
+	{&Enigma::TileSet::m_waterlayer_below,     "WaterLayerBelow.png"},
+	{&Enigma::TileSet::m_waterlayer_above,     "WaterLayerAbove.png"},
+	{&Enigma::TileSet::m_lightbeam_horizontal, "LightBeamHorizontal.png"},
+	{&Enigma::TileSet::m_lightbeam_vertical,   "LightBeamVertical.png"},
+	{&Enigma::TileSet::m_tree,                 "Tree.png"},
+	{&Enigma::TileSet::m_tree_horizontal,      "TreeHorizontal.png"},
+	{&Enigma::TileSet::m_tree_ceiling,         "TreeCeiling.png"},
+	{&Enigma::TileSet::m_tree_floor,           "TreeFloor.png"},
+	{&Enigma::TileSet::m_treetop,              "TreeTop.png"},
+	{&Enigma::TileSet::m_treetop_horizontal,   "TreeTopHorizontal.png"},
+	{&Enigma::TileSet::m_treetop_ceiling,      "TreeTopCeiling.png"},
+	{&Enigma::TileSet::m_treetop_floor,        "TreeTopFloor.png"},
+	{&Enigma::TileSet::m_catwalk_ceiling,      "CatWalkCeiling.png"},
+	{&Enigma::TileSet::m_catwalk_floor,        "CatWalkFloor.png"},
+	{&Enigma::TileSet::m_catwalk_horizontal,   "CatWalkHorizontal.png"},
+	{&Enigma::TileSet::m_catwalk_vertical,     "CatWalkVertical.png"},
+	{&Enigma::TileSet::m_teleporter_departure, "TeleporterDeparture.png"},
+	{&Enigma::TileSet::m_teleporter_arrival,   "TeleporterArrival.png"},
+	{&Enigma::TileSet::m_fern_floor,           "FernFloor.png"},
+	{&Enigma::TileSet::m_water,                "Water.png"},
+	{&Enigma::TileSet::m_earthwall_vertical,   "EarthWallVertical.png"},
+	{&Enigma::TileSet::m_earthwall_ceiling,    "EarthWallCeiling.png"},
+	{&Enigma::TileSet::m_earthwall_floor,      "EarthWallFloor.png"},
+	{&Enigma::TileSet::m_padbutton_ceiling,    "PadButtonCeiling.png"},
+	{&Enigma::TileSet::m_padbutton_floor,      "PadButtonFloor.png"},
+	{&Enigma::TileSet::m_padbutton_vertical,   "PadButtonVertical.png"}
+};
+
+//------------------------------------------------------------------------
+// This private function decodes a PNG image tile from the resource
+// bundle.  A missing or damaged image is replaced by an empty tile.
+//------------------------------------------------------------------------
+// filename: Name of PNG image file.
+// RETURN:   Image surface.
+//------------------------------------------------------------------------
+
+Cairo::RefPtr<Cairo::ImageSurface> decode_tile(const std::string& filename)
+{
+	try
+	{
+		Glib::RefPtr<const Glib::Bytes> bytes =
+			Gio::Resource::lookup_data_global(
+				std::string(G_RESOURCE_PREFIX) + "images/" + filename);
 
-	m_blocker_horizontal =
-		Cairo::ImageSurface::create_from_png("./images/BlockerHorizontal.png");
+		gsize size;
+		const guint8* data = (const guint8*)bytes->get_data(size);
+		gsize offset = 0;
 
-	m_mover =
-		Cairo::ImageSurface::create_from_png("./images/Mover.png");
+		return Cairo::ImageSurface::create_from_png_stream(
+			[&](unsigned char* buffer, unsigned int length)
+			{
+				if (length > (size - offset))
+					return CAIRO_STATUS_READ_ERROR;
 
-	m_mover_below =
-		Cairo::ImageSurface::create_from_png("./images/MoverBelow.png");
+				memcpy(buffer, data + offset, length);
+				offset += length;
+				return CAIRO_STATUS_SUCCESS;
+			});
+	}
+	catch(Glib::Error error)
+	{
+	}
+	catch(std::exception& error)
+	{
+	}
 
-	m_mover_above =
-		Cairo::ImageSurface::create_from_png("./images/MoverAbove.png");
+	return Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, TILESIZE, TILESIZE);
+}
 
-	m_turner =
-		Cairo::ImageSurface::create_from_png("./images/Turner.png");
+//---------------------------------------------------------------------
+// This private function sets a shared image surface as the source of
+// a drawing context.  Cairomm's set_source() makes a converted copy of
+// the surface's RefPtr, whose count may not be changed by several
+// threads at once, so the surface is given to Cairo directly.
+//---------------------------------------------------------------------
+// context: Cairo drawing context.
+// surface: Image surface.
+// x:       Surface left edge.
+// y:       Surface top edge.
+//---------------------------------------------------------------------
+
+void set_source_surface(const Cairo::RefPtr<Cairo::Context>& context,
+                        const Cairo::RefPtr<Cairo::ImageSurface>& surface,
+                        double x,
+                        double y)
+{
+	cairo_set_source_surface(context->cobj(), surface->cobj(), x, y);
+}
 
-	m_item =
-		Cairo::ImageSurface::create_from_png("./images/Item.png");
+//--------------------------------
+// This method is the constructor.
+//--------------------------------
 
-	m_flipper =
-		Cairo::ImageSurface::create_from_png("./images/Flipper.png");
+Enigma::TileSet::TileSet()
+{
+	// Decode the image tiles from the resource bundle compiled into the
+	// program, sharing them among worker threads.  Each thread decodes
+	// into its own surfaces, which are only used here once all threads
+	// have finished.
 
-	m_surfacer =
-		Cairo::ImageSurface::create_from_png("./images/Surfacer.png");
+	const guint TILES = sizeof(tile_files) / sizeof(tile_files[0]);
 
-	m_surfacer_corner =
-		Cairo::ImageSurface::create_from_png("./images/SurfacerCorner.png");
+	std::vector<Cairo::RefPtr<Cairo::ImageSurface>> images(TILES);
+	std::vector<std::thread> workers;
+	std::atomic<guint> next(0);
 
-	m_stairs =
-		Cairo::ImageSurface::create_from_png("./images/Stairs.png");
+	guint jobs = std::min(std::max(std::thread::hardware_concurrency(), 1u),
+	                      TILES);
 
-	m_stairstop =
-		Cairo::ImageSurface::create_from_png("./images/StairsTop.png");
+	for (guint job = 0; job < jobs; ++ job)
+	{
+		workers.emplace_back([&]()
+		{
+			guint tile;
 
-	m_handhold =
-		Cairo::ImageSurface::create_from_png("./images/HandHold.png");
+			while ((tile = next ++) < TILES)
+				images[tile] = decode_tile(tile_files[tile].m_filename);
+		});
+	}
 
-	m_handhold_horizontal =
-		Cairo::ImageSurface::create_from_png("./images/HandHoldHorizontal.png");
+	for (std::thread& worker : workers)
+		worker.join();
 
-	m_outdoor =
-		Cairo::ImageSurface::create_from_png("./images/Outdoor.png");
+	for (guint tile = 0; tile < TILES; ++ tile)
+		add_tile(tile_files[tile].m_image, images[tile]);
 
-	m_outdoor_vertical =
-		Cairo::ImageSurface::create_from_png("./images/OutdoorVertical.png");
+	// Draw every image tile in all four rotations into one atlas surface,
+	// so objects can be drawn without rotating the drawing context.
 
-	m_outdoor_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/OutdoorCeiling.png");
+	build_atlas();
+}
 
-	m_outdoor_floor =
-		Cairo::ImageSurface::create_from_png("./images/OutdoorFloor.png");
+//---------------------------------------------------------------------
+// This method returns the image tiles shared by all level viewers.
+// They are decoded when first needed, and released once no viewer
+// uses them.
+//---------------------------------------------------------------------
+// RETURN: Shared image tiles.
+//---------------------------------------------------------------------
 
-	m_indoor =
-		Cairo::ImageSurface::create_from_png("./images/Indoor.png");
+std::shared_ptr<const Enigma::TileSet> Enigma::TileSet::get()
+{
+	static std::mutex mutex;
+	static std::weak_ptr<const Enigma::TileSet> shared;
 
-	m_indoor_vertical =
-		Cairo::ImageSurface::create_from_png("./images/IndoorVertical.png");
+	std::lock_guard<std::mutex> lock(mutex);
+	std::shared_ptr<const Enigma::TileSet> set = shared.lock();
 
-	m_indoor_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/IndoorCeiling.png");
+	if (!set)
+	{
+		set = std::make_shared<const Enigma::TileSet>();
+		shared = set;
+	}
 
-	m_indoor_floor =
-		Cairo::ImageSurface::create_from_png("./images/IndoorFloor.png");
+	return set;
+}
 
-	m_archway_vertical =
-		Cairo::ImageSurface::create_from_png("./images/ArchWayVertical.png");
+//--------------------------------
+// This method is the constructor.
+//--------------------------------
 
-	m_archway_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/ArchWayCeiling.png");
+Enigma::Tiles::Tiles()
+{
+	m_set = Enigma::TileSet::get();
+	m_stack_hits = 0;
+	m_stack_misses = 0;
+	set_zoom(0);
+}
 
-	m_archway_floor =
-		Cairo::ImageSurface::create_from_png("./images/ArchWayFloor.png");
+//-----------------------------------------------
+// This method returns the image tile pixel size.
+//-----------------------------------------------
+// RETURN: Tile size.                            
+//-----------------------------------------------
 
-	m_wooddoor_vertical =
-		Cairo::ImageSurface::create_from_png("./images/WoodDoorVertical.png");
+int Enigma::Tiles::get_tile_size() const
+{
+	return m_size;
+}
 
-	m_wooddoor_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/WoodDoorCeiling.png");
+//-------------------------------------------------------------------
+// This method sets the zoom level.  Zoom level zero draws full-size
+// image tiles, and each higher level draws smaller ones.
+//-------------------------------------------------------------------
+// zoom: Zoom level (0 to get_zoom_levels() - 1).
+//-------------------------------------------------------------------
 
-	m_wooddoor_floor =
-		Cairo::ImageSurface::create_from_png("./images/WoodDoorFloor.png");
+void Enigma::Tiles::set_zoom(guint zoom)
+{
+	std::lock_guard<std::mutex> lock(m_stacks_mutex);
 
-	m_woodwall_vertical =
-		Cairo::ImageSurface::create_from_png("./images/WoodWallVertical.png");
+	m_zoom = std::min(zoom, get_zoom_levels() - 1);
+	m_size = zoom_sizes[m_zoom];
+	m_stacks.clear();
+}
 
-	m_woodwall_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/WoodWallCeiling.png");
+//-------------------------------------------
+// This method returns the zoom level.
+//-------------------------------------------
+// RETURN: Zoom level.
+//-------------------------------------------
 
-	m_woodwall_floor =
-		Cairo::ImageSurface::create_from_png("./images/WoodWallFloor.png");
+guint Enigma::Tiles::get_zoom() const
+{
+	return m_zoom;
+}
 
-	m_pullring_horizontal =
-		Cairo::ImageSurface::create_from_png("./images/PullRingHorizontal.png");
+//-------------------------------------------
+// This method returns the number of zoom levels.
+//-------------------------------------------
+// RETURN: Number of zoom levels.
+//-------------------------------------------
 
-	m_pullring_vertical =
-		Cairo::ImageSurface::create_from_png("./images/PullRingVertical.png");
+guint Enigma::Tiles::get_zoom_levels() const
+{
+	return sizeof(zoom_sizes) / sizeof(zoom_sizes[0]);
+}
 
-	m_lock_horizontal =
-		Cairo::ImageSurface::create_from_png("./images/LockHorizontal.png");
+//-------------------------------------------------------------------
+// This method returns TRUE if image tiles are drawn at the current
+// zoom level.  Otherwise, rooms are drawn as blocks of colour.
+//-------------------------------------------------------------------
+// RETURN: TRUE if image tiles are drawn.
+//-------------------------------------------------------------------
 
-	m_lock_vertical =
-		Cairo::ImageSurface::create_from_png("./images/LockVertical.png");
+bool Enigma::Tiles::get_detailed() const
+{
+	return (m_size >= DETAILSIZE);
+}
 
-	m_waterlayer_vertical =
-		Cairo::ImageSurface::create_from_png("./images/WaterLayerVertical.png");
+//---------------------------------------------------------------
+// This private method sets an image tile, and adds it to the list
+// of tiles to be placed in the atlas.
+//---------------------------------------------------------------
+// tile:  Image tile member.
+// image: Decoded image surface.
+//---------------------------------------------------------------
 
-	m_waterlayer_below =
-		Cairo::ImageSurface::create_from_png("./images/WaterLayerBelow.png");
+void Enigma::TileSet::add_tile(Cairo::RefPtr<Cairo::ImageSurface> Enigma::TileSet::* tile,
+                               const Cairo::RefPtr<Cairo::ImageSurface>& image)
+{
+	this->*tile = image;
+	m_atlas_rows[image.operator->()] = m_atlas_images.size();
+	m_atlas_images.push_back(image);
+}
 
-	m_waterlayer_above =
-		Cairo::ImageSurface::create_from_png("./images/WaterLayerAbove.png");
+//------------------------------------------------------------------------
+// This private method draws all loaded image tiles into the atlas.  Each
+// image occupies one row of the atlas, with one column for each rotation
+// (0, 90, 180, 270 degrees).
+//------------------------------------------------------------------------
 
-	m_lightbeam_horizontal =
-		Cairo::ImageSurface::create_from_png("./images/LightBeamHorizontal.png");
+void Enigma::TileSet::build_atlas()
+{
+	m_atlas = Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32,
+	                                      ROTATIONS * TILESIZE,
+	                                      m_atlas_images.size() * TILESIZE);
 
-	m_lightbeam_vertical =
-		Cairo::ImageSurface::create_from_png("./images/LightBeamVertical.png");
+	Cairo::RefPtr<Cairo::Context> context = Cairo::Context::create(m_atlas);
 
-	m_tree =
-		Cairo::ImageSurface::create_from_png("./images/Tree.png");
+	for (guint row = 0; row < m_atlas_images.size(); ++ row)
+	{
+		for (guint rotation = 0; rotation < ROTATIONS; ++ rotation)
+		{
+			// Rotate the image about its top-left corner, then move it back
+			// into its atlas cell.
 
-	m_tree_horizontal =
-		Cairo::ImageSurface::create_from_png("./images/TreeHorizontal.png");
+			double x = rotation * TILESIZE;
+			double y = row * TILESIZE;
 
-	m_tree_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/TreeCeiling.png");
+			if ((rotation == 1) || (rotation == 2))
+				x += TILESIZE;
 
-	m_tree_floor =
-		Cairo::ImageSurface::create_from_png("./images/TreeFloor.png");
+			if ((rotation == 2) || (rotation == 3))
+				y += TILESIZE;
 
-	m_treetop =
-		Cairo::ImageSurface::create_from_png("./images/TreeTop.png");
+			context->save();
+			context->translate(x, y);
+			context->rotate_degrees(rotation * 90);
+			context->set_source(m_atlas_images[row], 0, 0);
+			context->paint();
+			context->restore();
+		}
+	}
 
-	m_treetop_horizontal =
-		Cairo::ImageSurface::create_from_png("./images/TreeTopHorizontal.png");
+	// Reduce the atlas for each detailed zoom level, each from the one
+	// before it, so the image tiles are scaled down smoothly.
 
-	m_treetop_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/TreeTopCeiling.png");
+	m_atlases.clear();
+	m_atlases.push_back(m_atlas);
 
-	m_treetop_floor =
-		Cairo::ImageSurface::create_from_png("./images/TreeTopFloor.png");
+	for (guint zoom = 1; zoom_sizes[zoom] >= DETAILSIZE; ++ zoom)
+	{
+		int size = zoom_sizes[zoom];
+		int previous_size = zoom_sizes[zoom - 1];
 
-	m_catwalk_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/CatWalkCeiling.png");
+		Cairo::RefPtr<Cairo::ImageSurface> atlas =
+			Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32,
+			                            ROTATIONS * size,
+			                            m_atlas_images.size() * size);
 
-	m_catwalk_floor =
-		Cairo::ImageSurface::create_from_png("./images/CatWalkFloor.png");
+		context = Cairo::Context::create(atlas);
 
-	m_catwalk_horizontal =
-		Cairo::ImageSurface::create_from_png("./images/CatWalkHorizontal.png");
+		for (guint cell = 0; cell < ROTATIONS * m_atlas_images.size(); ++ cell)
+		{
+			// Scale each cell separately, so neighbouring cells do not
+			// blend together at their edges.
+
+			double x = (cell % ROTATIONS) * size;
+			double y = (cell / ROTATIONS) * size;
+
+			context->save();
+			context->rectangle(x, y, size, size);
+			context->clip();
+			context->translate(x, y);
+			context->scale((double)size / previous_size,
+			               (double)size / previous_size);
+			context->set_source(m_atlases.back(),
+			                    -(double)((cell % ROTATIONS) * previous_size),
+			                    -(double)((cell / ROTATIONS) * previous_size));
+			context->paint();
+			context->restore();
+		}
 
-	m_catwalk_vertical =
-		Cairo::ImageSurface::create_from_png("./images/CatWalkVertical.png");
+		m_atlases.push_back(atlas);
+	}
 
-	m_teleporter_departure =
-		Cairo::ImageSurface::create_from_png("./images/TeleporterDeparture.png");
+	// Find the average colour of each cell over a black background, for
+	// drawing rooms as blocks of colour.  Atlas pixels have their colour
+	// already multiplied by their opacity.
 
-	m_teleporter_arrival =
-		Cairo::ImageSurface::create_from_png("./images/TeleporterArrival.png"); 
+	m_atlas->flush();
 
-	m_fern_floor =
-		Cairo::ImageSurface::create_from_png("./images/FernFloor.png");  
+	const unsigned char* data = m_atlas->get_data();
+	int stride = m_atlas->get_stride();
 
-	m_water =
-		Cairo::ImageSurface::create_from_png("./images/Water.png");
+	m_cell_colours.assign(ROTATIONS * m_atlas_images.size(), 0);
 
-	m_earthwall_vertical =
-		Cairo::ImageSurface::create_from_png("./images/EarthWallVertical.png");
+	for (guint cell = 0; cell < m_cell_colours.size(); ++ cell)
+	{
+		guint64 red = 0;
+		guint64 green = 0;
+		guint64 blue = 0;
 
-	m_earthwall_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/EarthWallCeiling.png");
+		for (int y = 0; y < TILESIZE; ++ y)
+		{
+			const guint32* pixel = (const guint32*)(data
+				+ (((cell / ROTATIONS) * TILESIZE) + y) * stride)
+				+ ((cell % ROTATIONS) * TILESIZE);
 
-	m_earthwall_floor =
-		Cairo::ImageSurface::create_from_png("./images/EarthWallFloor.png");
+			for (int x = 0; x < TILESIZE; ++ x, ++ pixel)
+			{
+				red   += (*pixel >> 16) & 0xff;
+				green += (*pixel >> 8) & 0xff;
+				blue  += *pixel & 0xff;
+			}
+		}
 
-	m_padbutton_ceiling =
-		Cairo::ImageSurface::create_from_png("./images/PadButtonCeiling.png");
+		guint pixels = TILESIZE * TILESIZE;
 
-	m_padbutton_floor =
-		Cairo::ImageSurface::create_from_png("./images/PadButtonFloor.png");
+		m_cell_colours[cell] = ((red / pixels) << 16)
+		                     | ((green / pixels) << 8)
+		                     | (blue / pixels);
+	}
 
-	m_padbutton_vertical =
-		Cairo::ImageSurface::create_from_png("./images/PadButtonVertical.png");
+	build_cells();
 }
 
-//-----------------------------------------------
-// This method returns the image tile pixel size.
-//-----------------------------------------------
-// RETURN: Tile size.                            
-//-----------------------------------------------
+//----------------------------------------------------------------
+// This private method draws an atlas cell in a room, or a block
+// of the cell's average colour if image tiles are too small to
+// be drawn.
+//----------------------------------------------------------------
+// context:    Cairo context for drawing.
+// allocation: Pixel boundary of view.
+// column:     Visible column of map level.
+// row:        Visible row of map level.
+// cell:       Atlas cell number.
+//----------------------------------------------------------------
 
-int Enigma::Tiles::get_tile_size() const
+void Enigma::Tiles::draw_cell(const Cairo::RefPtr<Cairo::Context>& context,
+                              Gtk::Allocation allocation,
+                              guint16 column,
+                              guint16 row,
+                              gint cell)
 {
-	return TILESIZE;
-}
+	double x = column * m_size;
+	double y = allocation.get_height() - m_size - (row * m_size);
 
-//---------------------------------------------------
-// This private function draws an image tile.
-//---------------------------------------------------
-// context: Cairo drawing context.
-// x:       X screen pixel coordinate of tile.
-// y:       Y screen pixel coordinate of tile.
-// r:       Rotation amount (0, 90, 180, 270 degrees).
-// image:   Image surface to draw.
-//----------------------------------------------------
-
-void draw_tile(const Cairo::RefPtr<Cairo::Context>& context,
-              double x,
-              double y,
-              double r,
-              Cairo::RefPtr<Cairo::ImageSurface> image)
-{
-	if (r == 90)
-	{
-		x += TILESIZE;
-	}
-	else if (r == 180)
-	{
-		x += TILESIZE;
-		y += TILESIZE;
-	}	
-	else if (r == 270)
+	if (get_detailed())
 	{
-		y += TILESIZE;
+		set_source_surface(context,
+		                   m_set->m_atlases[m_zoom],
+		                   x - ((cell % Enigma::TileSet::ROTATIONS) * m_size),
+		                   y - ((cell / Enigma::TileSet::ROTATIONS) * m_size));
 	}
 	else
 	{
-		r = 0;
+		guint32 colour = m_set->m_cell_colours[cell];
+
+		context->set_source_rgb(((colour >> 16) & 0xff) / 255.0,
+		                        ((colour >> 8) & 0xff) / 255.0,
+		                        (colour & 0xff) / 255.0);
 	}
 
-	context->save();
-	context->translate(x, y);
-	context->rotate_degrees(r);
+	context->rectangle(x, y, m_size, m_size);
+	context->fill();
+}
+
+//--------------------------------------------------------
+// This method returns the atlas cell holding an image
+// tile with a rotation.
+//--------------------------------------------------------
+// image:    Image tile.
+// rotation: Rotation amount (0, 90, 180, 270 degrees).
+// RETURN:   Atlas cell number.
+//--------------------------------------------------------
 
-	context->set_source(image, 0, 0);
-	context->paint();
-	context->restore();
+gint Enigma::TileSet::get_cell(const Cairo::RefPtr<Cairo::ImageSurface>& image,
+                               int rotation) const
+{
+	return (m_atlas_rows.at(image.operator->()) * ROTATIONS)
+	       + ((rotation / 90) % ROTATIONS);
 }
 
 //--------------------------------------------------------
@@ -337,11 +863,20 @@ void Enigma::Tiles::draw_cursor(const Cairo::RefPtr<Cairo::Context>& context,
                                 guint16 column,
                                 guint16 row)
 {
-	double x = column * TILESIZE;
-	double y = allocation.get_height() - TILESIZE - (row * TILESIZE);
+	if (get_detailed())
+		draw_cell(context, allocation, column, row, m_set->get_cell(m_set->m_cursor, 0));
+	else
+	{
+		// The cursor tile's average colour is too faint, so draw a white
+		// block instead.
 
-	context->set_source(m_cursor, x, y);
-	context->paint();
+		double x = column * m_size;
+		double y = allocation.get_height() - m_size - (row * m_size);
+
+		context->set_source_rgb(1, 1, 1);
+		context->rectangle(x, y, m_size, m_size);
+		context->fill();
+	}
 }
 
 //--------------------------------------------------------
@@ -359,11 +894,7 @@ void Enigma::Tiles::draw_marker(const Cairo::RefPtr<Cairo::Context>& context,
                                 guint16 column,
                                 guint16 row)
 {
-	double x = column * TILESIZE;
-	double y = allocation.get_height() - TILESIZE - (row * TILESIZE);
-
-	context->set_source(m_marker, x, y);
-	context->paint();
+	draw_cell(context, allocation, column, row, m_set->get_cell(m_set->m_marker, 0));
 }
 
 //--------------------------------------------------------------
@@ -382,11 +913,7 @@ void Enigma::Tiles::draw_generic(const Cairo::RefPtr<Cairo::Context>& context,
                                  guint16 column,
                                  guint16 row)
 {
-	double x = column * TILESIZE;
-	double y = allocation.get_height() - TILESIZE - (row * TILESIZE);
-
-	context->set_source(m_generic, x, y);
-	context->paint();
+	draw_cell(context, allocation, column, row, m_set->get_cell(m_set->m_generic, 0));
 }
 
 //----------------------------------------------------------------
@@ -403,1377 +930,321 @@ void Enigma::Tiles::draw_arrival(const Cairo::RefPtr<Cairo::Context>& context,
                                  guint16 column,
                                  guint16 row)
 {
-	double x = column * TILESIZE;
-	double y = allocation.get_height() - TILESIZE - (row * TILESIZE);
-
-	context->set_source(m_teleporter_arrival, x, y);
-	context->paint();
+	draw_cell(context, allocation, column, row, m_set->get_cell(m_set->m_teleporter_arrival, 0));
 }
 
-//------------------------------------------------------------
-// This method draws a map object tile.  The lower-left corner
-// of the view is the origin (Row = 0, Column = 0).
-//------------------------------------------------------------
-// context:    Cairo context for drawing.
-// allocation: Pixel boundary of view.
-// column:     Visible column of map level.
-// row:        Visible row of map level.
-// object:     Map object to draw.
-// RETURN:     TRUE if an image was drawn.
-//------------------------------------------------------------
-
-bool Enigma::Tiles::draw_object(const Cairo::RefPtr<Cairo::Context>& context,
-                                Gtk::Allocation allocation,
-                                guint16 column,
-                                guint16 row,
-                                Enigma::Object& object)
+//---------------------------------------------------------------------
+// This private function returns the index of an object's atlas cell in
+// the table of cells.  Values beyond those known share the last index
+// of their kind.
+//---------------------------------------------------------------------
+// type:     Object type.
+// id:       Object ID.
+// surface:  Object surface.
+// rotation: Object rotation.
+// active:   TRUE if the object is an active player.
+// RETURN:   Table index.
+//---------------------------------------------------------------------
+
+guint get_cell_index(guint type,
+                     guint id,
+                     guint surface,
+                     guint rotation,
+                     bool active)
 {
-	bool drawn = true;
-	double x   = column * TILESIZE;
-	double y   = allocation.get_height() - TILESIZE - (row * TILESIZE);
-
-	if (object.m_type == Enigma::Object::Type::ITEM)
-	{
-		// Draw a generic image for an item.
-
-		draw_tile(context, x, y, 0, m_item);
-	}
-	else if (object.m_type == Enigma::Object::Type::TELEPORTER)
-	{
-		// Draw a general image for all teleporters.
-
-		draw_tile(context, x, y, 0, m_teleporter_departure);
-	}
-	else if (object.m_id == Enigma::Object::ID::STAIRS)
-	{
-		// Draw stairs image.
-		
-		switch (object.m_rotation)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_stairs); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_stairs);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_stairs);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_stairs);
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::STAIRSTOP)
-	{
-		switch (object.m_rotation)
-		{
-			// Draw StairsTop image.
-			
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_stairstop); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_stairstop);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_stairstop);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_stairstop);
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::ARCHWAY)
-	{
-		switch (object.m_surface)
-		{
-			// Draw ArchWay image.
-			
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_archway_vertical); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_archway_vertical);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_archway_vertical);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_archway_vertical);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 270, m_archway_ceiling);
-				break;
-
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 270, m_archway_floor);
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::WOODDOOR)
-	{
-		// Draw WoodDoor image.
-		
-		switch (object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_wooddoor_vertical); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_wooddoor_vertical);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_wooddoor_vertical);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_wooddoor_vertical);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 270, m_wooddoor_ceiling);
-				break;
-
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 270, m_wooddoor_floor);
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::PULLRING)
-	{
-		// Draw PullRing image.
-		
-		switch (object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_pullring_vertical); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_pullring_vertical);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_pullring_vertical);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_pullring_vertical);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_pullring_horizontal);	
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if ((object.m_id == Enigma::Object::ID::CUBELOCK)
-	      || (object.m_id == Enigma::Object::ID::SPHERELOCK)
-	      || (object.m_id == Enigma::Object::ID::WATERLOCK)
-	      || (object.m_id == Enigma::Object::ID::APPLELOCK)
-	      || (object.m_id == Enigma::Object::ID::ORANGELOCK)
-	      || (object.m_id == Enigma::Object::ID::WINELOCK))
-	{
-		// Draw generic lock image.
-		
-		switch (object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_lock_vertical); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_lock_vertical);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_lock_vertical);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_lock_vertical);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_lock_horizontal);	
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if ((object.m_id == Enigma::Object::ID::WATERLAYER))
-	{
-		// Draw WaterLayer image.
-		
-		switch(object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_waterlayer_vertical); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_waterlayer_vertical);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_waterlayer_vertical);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_waterlayer_vertical);
-				break;
-
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_waterlayer_below);	
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 0, m_waterlayer_above);	
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::WATER)
-	{
-		// Draw Water image.
-		
-		draw_tile(context, x, y, 0, m_water);
-	}
-	else if (object.m_id == Enigma::Object::ID::LIGHTBEAM)
-	{
-		// Draw LightBeam image.
-		
-		switch(object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_lightbeam_horizontal); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_lightbeam_horizontal);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_lightbeam_horizontal);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_lightbeam_horizontal);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_lightbeam_vertical);	
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::WOODWALL)
-	{
-		// Draw WoodWall image.
-		
-		switch(object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_woodwall_vertical); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_woodwall_vertical);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_woodwall_vertical);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_woodwall_vertical);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 0, m_woodwall_ceiling);
-				break;
-
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_woodwall_floor);
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::PADBUTTON)
-	{
-		// Draw PadButton image.
-		
-		switch(object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_padbutton_vertical); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_padbutton_vertical);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_padbutton_vertical);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_padbutton_vertical);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 0, m_padbutton_ceiling);
-				break;
-
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_padbutton_floor);
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::EARTHWALL)
-	{
-		// Draw EarthWall image.
-		
-		switch(object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_earthwall_vertical); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_earthwall_vertical);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_earthwall_vertical);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_earthwall_vertical);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 0, m_earthwall_ceiling);
-				break;
-
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_earthwall_floor);
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if ((object.m_id == Enigma::Object::ID::BLOCKWALL)
-	      || (object.m_id == Enigma::Object::ID::STONEWALL))      
-	{
-		// Draw BlockWall or StoneWall image.
-		
-		switch(object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_wall); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_wall);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_wall);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_wall);
-				break;
+	const guint TYPES = (guint)Enigma::Object::Type::TELEPORTER + 1;
+	const guint IDS = (guint)ID::TOTAL;
+	const guint DIRECTIONS = (guint)Direction::TOTAL;
+
+	guint index = std::min(type, TYPES);
+	index = (index * (IDS + 1)) + std::min(id, IDS);
+	index = (index * (DIRECTIONS + 1)) + std::min(surface, DIRECTIONS);
+	index = (index * (DIRECTIONS + 1)) + std::min(rotation, DIRECTIONS);
+	return (index * 2) + (active ? 1 : 0);
+}
 
-			case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 0, m_ceiling);
-				break;
+//---------------------------------------------------------------------
+// This private method fills the table of atlas cells for every object
+// type, ID, surface, rotation and player activity, so drawing an object
+// needs only one table look-up.
+//---------------------------------------------------------------------
 
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_floor);
-				break;
+void Enigma::TileSet::build_cells()
+{
+	const guint TYPES = (guint)Enigma::Object::Type::TELEPORTER + 1;
+	const guint IDS = (guint)ID::TOTAL;
+	const guint DIRECTIONS = (guint)Direction::TOTAL;
 
-			default:
-				drawn = false;
-				break;
-		}
-	}	
-	else if (object.m_id == Enigma::Object::ID::BLOCKER)
-	{
-		// Draw Blocker image.
-	
-		switch(object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_blocker); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_blocker);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_blocker);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_blocker);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_blocker_horizontal);
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::FLIPPER)
-	{
-		// Draw Flipper image.
+	m_atlas_cells.resize(
+		get_cell_index(TYPES, IDS, DIRECTIONS, DIRECTIONS, true) + 1);
 
-		switch(object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_surfacer); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_surfacer);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_surfacer);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_surfacer);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_flipper); 
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if ((object.m_id == Enigma::Object::ID::SURFACER)
-	      || (object.m_id == Enigma::Object::ID::EDGER))
+	for (guint id = 0; id <= IDS; ++ id)
 	{
-		// Draw Surfacer or Edger image on a horizontal surface.
+		// Gather the rules for this ID, or for the ID it is drawn as.
 
-		if  ((object.m_surface == Enigma::Object::Direction::ABOVE)
-		  || (object.m_surface == Enigma::Object::Direction::BELOW))
-		{
-			switch( object.m_rotation )
-			{
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_surfacer); 
-					break;
-
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_surfacer);
-					break;
-
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_surfacer);
-					break;
-
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_surfacer);
-					break;
+		ID drawn_as = (ID)id;
 
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else
+		for (const ID* alias : tile_aliases)
 		{
-			// Draw Surfacer or Edger image on a vertical surface.
-			
-			switch (object.m_surface)
-			{
-				case Enigma::Object::Direction::NORTH:
-					if (object.m_rotation == Enigma::Object::Direction::WEST)
-						draw_tile(context, x, y, 0, m_surfacer_corner);
-					else if (object.m_rotation == Enigma::Object::Direction::EAST)
-						draw_tile(context, x, y, 90, m_surfacer_corner);
-					else
-						draw_tile(context, x, y, 0, m_surfacer); 
-					break;
-
-				case Enigma::Object::Direction::SOUTH:
-					if ( object.m_rotation == Enigma::Object::Direction::WEST )
-						draw_tile(context, x, y, 270, m_surfacer_corner);
-					else if ( object.m_rotation == Enigma::Object::Direction::EAST )
-						draw_tile(context, x, y, 180, m_surfacer_corner);
-					else
-						draw_tile(context, x, y, 180, m_surfacer);
-					break;
-
-				case Enigma::Object::Direction::EAST:
-					if ( object.m_rotation == Enigma::Object::Direction::NORTH )
-						draw_tile(context, x, y, 90, m_surfacer_corner);
-					else if ( object.m_rotation == Enigma::Object::Direction::SOUTH )
-						draw_tile(context, x, y, 180, m_surfacer_corner);
-					else
-						draw_tile(context, x, y, 90, m_surfacer);
-					break;
-
-				case Enigma::Object::Direction::WEST:
-					if ( object.m_rotation == Enigma::Object::Direction::NORTH )
-						draw_tile(context, x, y, 0, m_surfacer_corner);
-					else if ( object.m_rotation == Enigma::Object::Direction::SOUTH )
-						draw_tile(context, x, y, 270, m_surfacer_corner);
-					else
-						draw_tile(context, x, y, 270, m_surfacer);
-					break;
-
-				default:
-					drawn = false;
-					break;
-			}
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::MOVER)
-	{
-		// Draw Mover image.
-		
-		switch (object.m_rotation)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_mover); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_mover);
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_mover);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_mover);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 0, m_mover_above);
-				break;
-
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_mover_below);
-				break;
-
-			default:
-				drawn = false;
-				break;
+			if (alias[0] == drawn_as)
+				drawn_as = alias[1];
 		}
-	}
-	else if (object.m_id == Enigma::Object::ID::TURNER)
-	{
-		// Draw Turner image.
-
-		draw_tile(context, x, y, 0, m_turner); 
-	}
-	else if (object.m_id == Enigma::Object::ID::LADDER)
-	{
-		if  ((object.m_rotation == Enigma::Object::Direction::ABOVE)
-		  || (object.m_rotation == Enigma::Object::Direction::BELOW))	  
-		{
-			// Draw horizontal surface Ladder image.
-
-			switch (object.m_surface)
-			{
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_ladder);
-					break;
-
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_ladder);
-					break;
 
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_ladder);
-					break;
+		std::vector<const TileRule*> rules;
 
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_ladder);
-					break;
-
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else if ((object.m_rotation == Enigma::Object::Direction::EAST)
-		      || (object.m_rotation == Enigma::Object::Direction::WEST))
+		for (const TileRule& rule : tile_rules)
 		{
-			// Draw vertical surface East/West Ladder image.
-
-			switch (object.m_surface)
-			{  
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 0, m_ladder_ceiling);
-					break;
-
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 0, m_ladder_floor);
-					break;
-
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_ladder_horizontal);
-					break;
-
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_ladder_horizontal);
-					break;
-
-				default:
-					drawn = false;
-					break;
-			}
+			if (rule.m_id == drawn_as)
+				rules.push_back(&rule);
 		}
-		else if ((object.m_rotation == Enigma::Object::Direction::NORTH)
-		      || (object.m_rotation == Enigma::Object::Direction::SOUTH))
-		{
-			// Draw vertical surface North/South Ladder image.
-
-			switch (object.m_surface)
-			{  
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 90, m_ladder_floor);
-					break;
-
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 90, m_ladder_ceiling);
-					break;
-
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_ladder_horizontal);
-					break;
 
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_ladder_horizontal);
-					break;
-
-				default:
-					drawn = false;
-					break;
-			}
-		}  
-	}
-	else if ( object.m_id == Enigma::Object::ID::LADDEREND)
-	{
-		if  ((object.m_rotation == Enigma::Object::Direction::ABOVE)
-		  || (object.m_rotation == Enigma::Object::Direction::BELOW))
+		for (guint type = 0; type <= TYPES; ++ type)
+		for (guint surface = 0; surface <= DIRECTIONS; ++ surface)
+		for (guint rotation = 0; rotation <= DIRECTIONS; ++ rotation)
+		for (guint active = 0; active < 2; ++ active)
 		{
-			// Draw a vertical LadderTop image.
+			gint cell = CELL_NONE;
 
-			switch (object.m_surface)
+			if (type == (guint)Enigma::Object::Type::ITEM)
 			{
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_ladderend); 
-					break;
-
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_ladderend);
-					break;
-
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_ladderend);
-					break;
-
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_ladderend);
-					break;
+				// Draw a generic image for an item.
 
-				default:
-					drawn = false;
-					break;
+				cell = get_cell(m_item, 0);
 			}
-		}
-		else if (object.m_rotation == Enigma::Object::Direction::WEST)
-		{
-			// Draw West rotation LadderTop image.
-
-			switch (object.m_surface)
+			else if (type == (guint)Enigma::Object::Type::TELEPORTER)
 			{
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_ladderend_horizontal); 
-					break;
+				// Draw a general image for all teleporters.
 
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 270, m_ladderend_horizontal);
-					break;
-
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 0, m_ladderend_ceiling);
-					break;
-
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 0, m_ladderend_floor);
-					break;
-
-				default:
-					drawn = false;
-					break;
+				cell = get_cell(m_teleporter_departure, 0);
 			}
-		}
-		else if (object.m_rotation == Enigma::Object::Direction::EAST)
-		{
-			// Draw East rotation LadderTop image.
-
-			switch (object.m_surface)
+			else if (drawn_as == ID::PERSON)
 			{
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 90, m_ladderend_horizontal); 
-					break;
-
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_ladderend_horizontal);
-					break;
-
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 180, m_ladderend_ceiling);
-					break;
+				// Draw a Person image associated with a player.
 
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 180, m_ladderend_floor);
-					break;
-
-				default:
-					drawn = false;
-					break;
+				cell = get_cell(active ? m_player_active : m_player_idle, 0);
 			}
-		}
-		else if (object.m_rotation == Enigma::Object::Direction::NORTH)
-		{
-			// Draw a North rotation LadderTop image.
-
-			switch (object.m_surface)
+			else
 			{
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 0, m_ladderend_horizontal); 
-					break;
-
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_ladderend_horizontal );
-					break;
-
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 90, m_ladderend_floor);
-					break;
-
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 90, m_ladderend_ceiling);
-					break;
-
-				default:
-					drawn = false;
-					break;
+				for (const TileRule* rule : rules)
+				{
+					if (((rule->m_surface == ANY)
+					     || ((guint)rule->m_surface == surface))
+					    && ((rule->m_rotation == ANY)
+					     || ((guint)rule->m_rotation == rotation)))
+					{
+						cell = get_cell(this->*(rule->m_image), rule->m_angle);
+						break;
+					}
+				}
 			}
-		}
-		else if (object.m_rotation == Enigma::Object::Direction::SOUTH)
-		{
-			// Draw a South rotation LadderTop image.
-
-			switch (object.m_surface)
-			{
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_ladderend_horizontal); 
-					break;
-
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 180, m_ladderend_horizontal);
-					break;
-
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 270, m_ladderend_floor);
-					break;
 
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 270, m_ladderend_ceiling);
-					break;
-
-				default:
-					drawn = false;
-					break;
-			}
+			m_atlas_cells[get_cell_index(type, id, surface, rotation, active)] =
+				cell;
 		}
-		else
-			drawn = false;
 	}
-	else if (object.m_id == Enigma::Object::ID::TREE)
-	{
-		if  ((object.m_surface == Enigma::Object::Direction::ABOVE)
-		  || (object.m_surface == Enigma::Object::Direction::BELOW))	  
-		{
-			// Draw image of Tree growing on Above/Below surface.
+}
 
-			switch (object.m_rotation)
-			{
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_tree);
-					break;
+//-------------------------------------------------------------------
+// This method returns the atlas cell holding an object's image tile.
+//-------------------------------------------------------------------
+// object: Map object.
+// RETURN: Atlas cell number, or CELL_NONE if it has no image tile.
+//-------------------------------------------------------------------
 
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_tree);
-					break;
+gint Enigma::TileSet::get_cell(const Enigma::Object& object) const
+{
+	return m_atlas_cells[get_cell_index((guint)object.m_type,
+	                                    (guint)object.m_id,
+	                                    (guint)object.m_surface,
+	                                    (guint)object.m_rotation,
+	                                    object.m_active)];
+}
 
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_tree);
-					break;
+//------------------------------------------------------------
+// This method draws a map object tile.  The lower-left corner
+// of the view is the origin (Row = 0, Column = 0).
+//------------------------------------------------------------
+// context:    Cairo context for drawing.
+// allocation: Pixel boundary of view.
+// column:     Visible column of map level.
+// row:        Visible row of map level.
+// object:     Map object to draw.
+// RETURN:     TRUE if an image was drawn.
+//------------------------------------------------------------
 
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_tree);
-					break;
+bool Enigma::Tiles::draw_object(const Cairo::RefPtr<Cairo::Context>& context,
+                                Gtk::Allocation allocation,
+                                guint16 column,
+                                guint16 row,
+                                Enigma::Object& object)
+{
+	gint cell = m_set->get_cell(object);
 
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else if ((object.m_surface == Enigma::Object::Direction::EAST)
-		      || (object.m_surface == Enigma::Object::Direction::WEST))
-		{
-			// Draw image of Tree growing on the East/West surface.
+	if (cell == Enigma::TileSet::CELL_NONE)
+		return false;
 
-			switch (object.m_rotation)
-			{  
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 0, m_tree_ceiling);
-					break;
+	draw_cell(context, allocation, column, row, cell);
+	return true;
+}
 
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 0, m_tree_floor);
-					break;
+//---------------------------------------------------------------------
+// This method draws a stack of map objects in one room, in the order
+// given.  Objects without an image are drawn as generic tiles.  Rooms
+// hold the same few stacks over and over, so a stack of several image
+// tiles is composited once at each zoom level and then drawn with a
+// single copy.
+//---------------------------------------------------------------------
+// context:    Cairo context for drawing.
+// allocation: Pixel boundary of view.
+// column:     Visible column of map level.
+// row:        Visible row of map level.
+// objects:    Map objects to draw, in drawing order.
+//---------------------------------------------------------------------
+
+void Enigma::Tiles::draw_stack(const Cairo::RefPtr<Cairo::Context>& context,
+                               Gtk::Allocation allocation,
+                               guint16 column,
+                               guint16 row,
+                               const std::vector<Enigma::Object*>& objects)
+{
+	std::vector<gint16> stack;
 
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_tree_horizontal);
-					break;
+	stack.reserve(objects.size());
 
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_tree_horizontal);
-					break;
+	for (const Enigma::Object* object : objects)
+	{
+		gint cell = m_set->get_cell(*object);
 
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else if ((object.m_surface == Enigma::Object::Direction::NORTH)
-		      || (object.m_surface == Enigma::Object::Direction::SOUTH))
-		{
-			// Draw image of Tree growing on the North/South surface.
+		if (cell == Enigma::TileSet::CELL_NONE)
+			cell = m_set->get_cell(m_set->m_generic, 0);
 
-			switch (object.m_rotation)
-			{  
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 90, m_tree_floor);
-					break;
+		stack.push_back(cell);
+	}
 
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 90, m_tree_ceiling);
-					break;
+	const Cairo::RefPtr<Cairo::ImageSurface>* tile = nullptr;
 
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_tree_horizontal);
-					break;
+	if (get_detailed() && (stack.size() > 1))
+		tile = find_stack(stack);
 
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_tree_horizontal);
-					break;
+	if (tile)
+	{
+		double x = column * m_size;
+		double y = allocation.get_height() - m_size - (row * m_size);
 
-				default:
-					drawn = false;
-					break;
-			}
-		}  
+		set_source_surface(context, *tile, x, y);
+		context->rectangle(x, y, m_size, m_size);
+		context->fill();
 	}
-	else if (object.m_id == Enigma::Object::ID::TREETOP)
+	else
 	{
-		if  ((object.m_surface == Enigma::Object::Direction::ABOVE)
-		  || (object.m_surface == Enigma::Object::Direction::BELOW))
-		{
-			// Draw a tree top on the Above/Below surface.
-
-			switch (object.m_rotation)
-			{
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_treetop); 
-					break;
-
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_treetop);
-					break;
-
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_treetop);
-					break;
-
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_treetop);
-					break;
-
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else if (object.m_surface == Enigma::Object::Direction::WEST)
-		{
-			// Draw image of TreeTop on West surface.
-
-			switch (object.m_rotation)
-			{
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_treetop_horizontal); 
-					break;
-
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 270, m_treetop_horizontal);
-					break;
-
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 0, m_treetop_ceiling);
-					break;
-
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 0, m_treetop_floor);
-					break;
-
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else if ( object.m_surface == Enigma::Object::Direction::EAST )
-		{
-			// Draw image of TreeTop on East surface.
-
-			switch (object.m_rotation)
-			{
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 90, m_treetop_horizontal); 
-					break;
-
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_treetop_horizontal);
-					break;
-
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 180, m_treetop_ceiling);
-					break;
-
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 180, m_treetop_floor);
-					break;
-
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else if ( object.m_surface == Enigma::Object::Direction::NORTH )
-		{
-			// Draw a tree top on the North surface.
-
-			switch (object.m_rotation)
-			{
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 0, m_treetop_horizontal); 
-					break;
-
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_treetop_horizontal);
-					break;
-
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 90, m_treetop_floor);
-					break;
-
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 90, m_treetop_ceiling);
-					break;
-
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else if ( object.m_surface == Enigma::Object::Direction::SOUTH )
-		{
-			// Draw image of TreeTop on South surface.
-
-			switch (object.m_rotation)
-			{
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_treetop_horizontal); 
-					break;
-
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 180, m_treetop_horizontal);
-					break;
+		for (gint cell : stack)
+			draw_cell(context, allocation, column, row, cell);
+	}
+}
 
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 270, m_treetop_floor);
-					break;
+//---------------------------------------------------------------------
+// This private method finds the composited tile of a stack of atlas
+// cells, compositing it if it has not been drawn before.  Stacks are
+// drawn by several threads at once, so the cache is locked.  Tiles
+// are only removed when the zoom level changes, so the one returned
+// stays valid while the view is being drawn.
+//---------------------------------------------------------------------
+// stack:  Atlas cells, in drawing order.
+// RETURN: Composited tile, or nullptr if the cache is full.
+//---------------------------------------------------------------------
+
+const Cairo::RefPtr<Cairo::ImageSurface>*
+Enigma::Tiles::find_stack(const std::vector<gint16>& stack)
+{
+	std::lock_guard<std::mutex> lock(m_stacks_mutex);
 
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 270, m_treetop_ceiling);
-					break;
+	auto found = m_stacks.find(stack);
 
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else
-			drawn = false;
-	}
-	else if (object.m_id == Enigma::Object::ID::CATWALK)
+	if (found != m_stacks.end())
 	{
-		if  ((object.m_rotation == Enigma::Object::Direction::ABOVE)
-		  || (object.m_rotation == Enigma::Object::Direction::BELOW))	  
-		{
-			// Draw image of Above/Below CatWalk. 
+		++ m_stack_hits;
+		return &found->second;
+	}
 
-			switch (object.m_surface)
-			{
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_catwalk_vertical);
-					break;
+	++ m_stack_misses;
 
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_catwalk_vertical);
-					break;
+	if (m_stacks.size() >= STACKSMAX)
+		return nullptr;
 
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_catwalk_vertical);
-					break;
+	Cairo::RefPtr<Cairo::ImageSurface> tile =
+		Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, m_size, m_size);
 
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_catwalk_vertical);
-					break;
+	Cairo::RefPtr<Cairo::Context> context = Cairo::Context::create(tile);
 
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else if ((object.m_rotation == Enigma::Object::Direction::EAST)
-		      || (object.m_rotation == Enigma::Object::Direction::WEST))
-		{
-			// Draw image of East/West catwalk.
-
-			switch (object.m_surface)
-			{  
-				case Enigma::Object::Direction::ABOVE:
-					draw_tile(context, x, y, 0, m_catwalk_ceiling);
-					break;
+	for (gint cell : stack)
+	{
+		set_source_surface(context,
+		                   m_set->m_atlases[m_zoom],
+		                   -((cell % Enigma::TileSet::ROTATIONS) * m_size),
+		                   -((cell / Enigma::TileSet::ROTATIONS) * m_size));
 
-				case Enigma::Object::Direction::BELOW:
-					draw_tile(context, x, y, 0, m_catwalk_floor);
-					break;
+		context->rectangle(0, 0, m_size, m_size);
+		context->fill();
+	}
 
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_catwalk_horizontal);
-					break;
+	return &m_stacks.emplace(stack, tile).first->second;
+}
 
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_catwalk_horizontal);
-					break;
+//---------------------------------------------------------------------
+// This method returns how many stacks of several tiles were found in
+// the composited tile cache, and how many were not, since it was last
+// called.
+//---------------------------------------------------------------------
+// hits:   Set to the stacks found.
+// misses: Set to the stacks not found.
+//---------------------------------------------------------------------
 
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else if ((object.m_rotation == Enigma::Object::Direction::NORTH)
-		      || (object.m_rotation == Enigma::Object::Direction::SOUTH))
-		{
-			// Draw image of North/South catwalk.
+void Enigma::Tiles::take_stack_counts(guint& hits, guint& misses)
+{
+	std::lock_guard<std::mutex> lock(m_stacks_mutex);
 
-			switch (object.m_surface)
-			{  
-				case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 90, m_catwalk_floor);
-				break;
+	hits   = m_stack_hits;
+	misses = m_stack_misses;
 
-				case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 90, m_catwalk_ceiling);
-				break;
+	m_stack_hits = 0;
+	m_stack_misses = 0;
+}
 
-				case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_catwalk_horizontal);
-				break;
+//---------------------------------------------------------------------
+// This method hashes a stack of atlas cells (FNV-1a).
+//---------------------------------------------------------------------
+// stack:  Atlas cells, in drawing order.
+// RETURN: Hash value.
+//---------------------------------------------------------------------
 
-				case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_catwalk_horizontal);
-				break;
+size_t Enigma::Tiles::StackHash::operator()(
+	const std::vector<gint16>& stack) const
+{
+	size_t hash = 2166136261u;
 
-				default:
-				drawn = false;
-				break;
-			}
-		}  
-	}
-	else if (object.m_id == Enigma::Object::ID::FERN)
+	for (gint16 cell : stack)
 	{
-		// Draw image of Fern on the Below surface growing out from
-		// a vertical surface.
-		
-		if (object.m_rotation == Enigma::Object::Direction::BELOW)
-		{
-			switch (object.m_surface)
-			{  
-				case Enigma::Object::Direction::NORTH:
-					draw_tile(context, x, y, 0, m_fern_floor);
-					break;
-
-				case Enigma::Object::Direction::EAST:
-					draw_tile(context, x, y, 90, m_fern_floor);
-					break;
-
-				case Enigma::Object::Direction::SOUTH:
-					draw_tile(context, x, y, 180, m_fern_floor);
-					break;
-
-				case Enigma::Object::Direction::WEST:
-					draw_tile(context, x, y, 270, m_fern_floor);
-					break;
-
-				default:
-					drawn = false;
-					break;
-			}
-		}
-		else
-			drawn = false;
+		hash ^= (guint16)cell;
+		hash *= 16777619u;
 	}
-	else if (object.m_id == Enigma::Object::ID::HANDHOLD)
-	{
-		if ((((object.m_surface == Enigma::Object::Direction::ABOVE)
-		   || (object.m_surface == Enigma::Object::Direction::BELOW))  
-		   && (object.m_rotation == Enigma::Object::Direction::NORTH))
-		   ||
-		    (((object.m_rotation == Enigma::Object::Direction::ABOVE)
-		   || (object.m_rotation == Enigma::Object::Direction::BELOW))
-		   && (object.m_surface == Enigma::Object::Direction::NORTH)))
-		{
-			draw_tile(context, x, y, 0, m_handhold); 
-		}
-		else if ((((object.m_surface == Enigma::Object::Direction::ABOVE)
-		  || (object.m_surface == Enigma::Object::Direction::BELOW))  
-		  && (object.m_rotation == Enigma::Object::Direction::EAST))
-		  ||
-		  (((object.m_rotation == Enigma::Object::Direction::ABOVE)
-		  || (object.m_rotation == Enigma::Object::Direction::BELOW))
-		  && (object.m_surface == Enigma::Object::Direction::EAST)))
-		{
-			draw_tile(context, x, y, 90, m_handhold); 
-		}
-		else if ((((object.m_surface == Enigma::Object::Direction::ABOVE)
-		  || (object.m_surface == Enigma::Object::Direction::BELOW))  
-		  && (object.m_rotation == Enigma::Object::Direction::SOUTH))
-		  ||
-		  (((object.m_rotation == Enigma::Object::Direction::ABOVE)
-		  || (object.m_rotation == Enigma::Object::Direction::BELOW))
-		  && (object.m_surface == Enigma::Object::Direction::SOUTH)))
-		{
-			draw_tile(context, x, y, 180, m_handhold); 
-		}
-		else if ((((object.m_surface == Enigma::Object::Direction::ABOVE)
-		  || (object.m_surface == Enigma::Object::Direction::BELOW))  
-		  && (object.m_rotation == Enigma::Object::Direction::WEST))
-		  ||
-		  (((object.m_rotation == Enigma::Object::Direction::ABOVE)
-		  || (object.m_rotation == Enigma::Object::Direction::BELOW))
-		  && (object.m_surface == Enigma::Object::Direction::WEST)))
-		{
-			draw_tile(context, x, y, 270, m_handhold); 
-		}
-		else if (((object.m_surface == Enigma::Object::Direction::NORTH)
-		  && (object.m_rotation == Enigma::Object::Direction::WEST))
-		  || ((object.m_surface == Enigma::Object::Direction::WEST)
-		  && (object.m_rotation == Enigma::Object::Direction::NORTH)))
-		{
-			draw_tile(context, x, y, 0, m_handhold_horizontal);
-		}
-		else if (((object.m_surface == Enigma::Object::Direction::EAST)
-		  && (object.m_rotation == Enigma::Object::Direction::NORTH))
-		  || ((object.m_surface == Enigma::Object::Direction::NORTH)
-		  && (object.m_rotation == Enigma::Object::Direction::EAST)))
-		{
-			draw_tile(context, x, y, 90, m_handhold_horizontal);
-		}
-		else if (((object.m_surface == Enigma::Object::Direction::SOUTH)
-		  && (object.m_rotation == Enigma::Object::Direction::EAST))
-		  || ((object.m_surface == Enigma::Object::Direction::EAST)
-		  && (object.m_rotation == Enigma::Object::Direction::SOUTH)))
-		{
-			draw_tile(context, x, y, 180, m_handhold_horizontal);
-		}
-		else if (((object.m_surface == Enigma::Object::Direction::WEST)
-		  && (object.m_rotation == Enigma::Object::Direction::SOUTH))
-		  || ((object.m_surface == Enigma::Object::Direction::SOUTH)
-		  && (object.m_rotation == Enigma::Object::Direction::WEST)))
-		{
-			draw_tile(context, x, y, 270, m_handhold_horizontal);
-		}	  
-		else
-			drawn = false;
-	}
-	else if (object.m_id == Enigma::Object::ID::OUTDOOR)      
-	{
-		// Draw an Outdoor environment image.
-		
-		switch (object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_outdoor_vertical); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_outdoor_vertical );
-				break;
-
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_outdoor_vertical );
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_outdoor_vertical );
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 0, m_outdoor_ceiling);
-				break;
-
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_outdoor_floor);
-				break;
-
-			case Enigma::Object::Direction::CENTER:
-				draw_tile(context, x, y, 0, m_outdoor);
-				break;
-
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::INDOOR)      
-	{
-		// Draw an Indoor environment image.
-		
-		switch (object.m_surface)
-		{
-			case Enigma::Object::Direction::NORTH:
-				draw_tile(context, x, y, 0, m_indoor_vertical); 
-				break;
-
-			case Enigma::Object::Direction::SOUTH:
-				draw_tile(context, x, y, 180, m_indoor_vertical);
-				break;
 
-			case Enigma::Object::Direction::EAST:
-				draw_tile(context, x, y, 90, m_indoor_vertical);
-				break;
-
-			case Enigma::Object::Direction::WEST:
-				draw_tile(context, x, y, 270, m_indoor_vertical);
-				break;
-
-			case Enigma::Object::Direction::ABOVE:
-				draw_tile(context, x, y, 0, m_indoor_ceiling);
-				break;
+	return hash;
+}
 
-			case Enigma::Object::Direction::BELOW:
-				draw_tile(context, x, y, 0, m_indoor_floor);
-				break;
+//-------------------------------------------------------------------
+// This method returns the colour of an object when drawn as a block,
+// which is the average colour of its image tile.
+//-------------------------------------------------------------------
+// object: Map object.
+// RETURN: Colour (0xRRGGBB).
+//-------------------------------------------------------------------
 
-			case Enigma::Object::Direction::CENTER:
-				draw_tile(context, x, y, 0, m_indoor);
-				break;
+guint32 Enigma::Tiles::get_colour(const Enigma::Object& object) const
+{
+	gint cell = m_set->get_cell(object);
 
-			default:
-				drawn = false;
-				break;
-		}
-	}
-	else if (object.m_id == Enigma::Object::ID::PERSON)
-	{
-		// Draw a Person image associated with a player.
-		
-		if (object.m_active)
-			draw_tile(context, x, y, 0, m_player_active);
-		else
-			draw_tile(context, x, y, 0, m_player_idle);
-	}
-	else
-		drawn = false;
+	if (cell == Enigma::TileSet::CELL_NONE)
+		cell = m_set->get_cell(m_set->m_generic, 0);
 
-	return drawn;
+	return m_set->m_cell_colours[cell];
 }
-
@@ -2,7 +2,8 @@
 // Copyright (C) 2021 Chris Sterne <chris_sterne@hotmail.com>
 //
 // This file is the Tiles class header.  The Tiles class draws object image
-// tiles in a game world level viewer.
+// tiles in a game world level viewer.  The TileSet class holds the image
+// tiles, which are shared by all level viewers.
 //
 // This program is free software: you can redistribute it and/or modify it
 // under the terms of the GNU General Public License as published by the Free
@@ -20,6 +21,11 @@
 #ifndef __TILES_H__
 #define __TILES_H__
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include <cairomm/context.h>
 #include <cairomm/surface.h>
 #include <gtkmm/widget.h>
@@ -27,39 +33,23 @@
 
 namespace Enigma
 {
-	class Tiles
+	class TileSet
 	{
 		public:
-			// Public methods.
-
-			Tiles();
-			int get_tile_size() const;
+			// Public declarations.
 
-			bool draw_object(const Cairo::RefPtr<Cairo::Context>& context,
-			                 Gtk::Allocation allocation,
-			                 unsigned short column,
-			                 unsigned short row,
-			                 Enigma::Object& object);
+			static const guint ROTATIONS = 4;     // Atlas columns for rotations.
+			static const gint CELL_NONE = -1;     // Object has no image tile.
 
-			void draw_arrival(const Cairo::RefPtr<Cairo::Context>& context,
-			                  Gtk::Allocation allocation,                      
-			                  unsigned short column,
-			                  unsigned short row );
+			// Public methods.
 
-			void draw_generic(const Cairo::RefPtr<Cairo::Context>& context,
-			                  Gtk::Allocation allocation,                      
-			                  unsigned short column,
-			                  unsigned short row);
+			TileSet();
+			static std::shared_ptr<const Enigma::TileSet> get();
 
-			void draw_cursor(const Cairo::RefPtr<Cairo::Context>& context,
-			                 Gtk::Allocation allocation,
-			                 unsigned short column,
-			                 unsigned short row);
+			gint get_cell(const Cairo::RefPtr<Cairo::ImageSurface>& image,
+			              int rotation) const;
 
-			void draw_marker(const Cairo::RefPtr<Cairo::Context>& context,
-			                 Gtk::Allocation allocation,
-			                 unsigned short column,
-			                 unsigned short row);
+			gint get_cell(const Enigma::Object& object) const;
 
 		// Public data.
 
@@ -140,7 +130,108 @@ namespace Enigma
 		Cairo::RefPtr<Cairo::ImageSurface> m_earthwall_floor;
 		Cairo::RefPtr<Cairo::ImageSurface> m_padbutton_vertical;
 		Cairo::RefPtr<Cairo::ImageSurface> m_padbutton_ceiling;
-		Cairo::RefPtr<Cairo::ImageSurface> m_padbutton_floor;   
+		Cairo::RefPtr<Cairo::ImageSurface> m_padbutton_floor;
+
+		Cairo::RefPtr<Cairo::ImageSurface> m_atlas;   // All tiles, rotated.
+		std::vector<Cairo::RefPtr<Cairo::ImageSurface>> m_atlases;  // Zoomed.
+		std::vector<guint32> m_cell_colours;          // Average cell colours.
+
+		private:
+			// Private methods.
+
+			void add_tile(Cairo::RefPtr<Cairo::ImageSurface> Enigma::TileSet::* tile,
+			              const Cairo::RefPtr<Cairo::ImageSurface>& image);
+
+			void build_atlas();
+			void build_cells();
+
+			// Private data.
+
+			std::vector<Cairo::RefPtr<Cairo::ImageSurface>> m_atlas_images;
+			std::map<const Cairo::ImageSurface*, guint> m_atlas_rows;
+			std::vector<gint16> m_atlas_cells;            // Cells of objects.
+	};
+
+	class Tiles
+	{
+		public:
+			// Public methods.
+
+			Tiles();
+			int get_tile_size() const;
+			void set_zoom(guint zoom);
+			guint get_zoom() const;
+			guint get_zoom_levels() const;
+			bool get_detailed() const;
+			guint32 get_colour(const Enigma::Object& object) const;
+
+			bool draw_object(const Cairo::RefPtr<Cairo::Context>& context,
+			                 Gtk::Allocation allocation,
+			                 unsigned short column,
+			                 unsigned short row,
+			                 Enigma::Object& object);
+
+			void draw_stack(const Cairo::RefPtr<Cairo::Context>& context,
+			                Gtk::Allocation allocation,
+			                unsigned short column,
+			                unsigned short row,
+			                const std::vector<Enigma::Object*>& objects);
+
+			void take_stack_counts(guint& hits, guint& misses);
+
+			void draw_arrival(const Cairo::RefPtr<Cairo::Context>& context,
+			                  Gtk::Allocation allocation,                      
+			                  unsigned short column,
+			                  unsigned short row );
+
+			void draw_generic(const Cairo::RefPtr<Cairo::Context>& context,
+			                  Gtk::Allocation allocation,                      
+			                  unsigned short column,
+			                  unsigned short row);
+
+			void draw_cursor(const Cairo::RefPtr<Cairo::Context>& context,
+			                 Gtk::Allocation allocation,
+			                 unsigned short column,
+			                 unsigned short row);
+
+			void draw_marker(const Cairo::RefPtr<Cairo::Context>& context,
+			                 Gtk::Allocation allocation,
+			                 unsigned short column,
+			                 unsigned short row);
+
+		private:
+			// Private methods.
+
+			void draw_cell(const Cairo::RefPtr<Cairo::Context>& context,
+			               Gtk::Allocation allocation,
+			               unsigned short column,
+			               unsigned short row,
+			               gint cell);
+
+			const Cairo::RefPtr<Cairo::ImageSurface>*
+				find_stack(const std::vector<gint16>& stack);
+
+			// Private declarations.
+
+			class StackHash           // Hash of a stack of atlas cells.
+			{
+				public:
+					size_t operator()(const std::vector<gint16>& stack) const;
+			};
+
+			// Private data.
+
+			std::shared_ptr<const Enigma::TileSet> m_set;  // Shared image tiles.
+			guint m_zoom;                                 // Zoom level.
+			int m_size;                                   // Room pixel size.
+
+			std::unordered_map<std::vector<gint16>,       // Composited stacks.
+			                   Cairo::RefPtr<Cairo::ImageSurface>,
+			                   StackHash> m_stacks;
+
+			guint m_stack_hits;                           // Stacks found in cache.
+			guint m_stack_misses;                         // Stacks not found.
+			std::mutex m_stacks_mutex;                    // Guards stacks, counts.
 	};
 }
 
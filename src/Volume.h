@@ -20,7 +20,6 @@
 #ifndef __VOLUME_H__
 #define __VOLUME_H__
 
-#include <gtkmm.h>
 #include "Position.h"
 
 namespace Enigma
@@ -17,9 +17,41 @@
 // You should have received a copy of the GNU General Public License along
 // with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <vector>
 #include <glibmm/i18n.h>
+#include <glibmm/stringutils.h>
+#include <giomm/file.h>
+#include <giomm/fileinputstream.h>
+#include <giomm/converterinputstream.h>
+#include <giomm/converteroutputstream.h>
+#include <giomm/zlibcompressor.h>
+#include <giomm/zlibdecompressor.h>
+#include "Hash.h"
 #include "World.h"
 
+//-------------------
+// Local declarations
+//-------------------
+
+#define STREAM_BLOCK 65536     // Byte size of a file stream transfer.
+#define SEGMENT_OBJECTS 4096   // Number of objects in a loading segment.
+
+class Segment                          // Run of objects in file data.
+{
+	public:
+		guint m_start;                     // Index of first object.
+		guint m_end;                       // Index just past last object.
+		Enigma::Object m_state;            // Carried state before first object.
+		Enigma::ObjectList m_objects;      // Extracted structural objects.
+		Enigma::ObjectList m_players;      // Extracted player objects.
+		Enigma::ObjectList m_items;        // Extracted item objects.
+		Enigma::ObjectList m_teleporters;  // Extracted teleporter objects.
+		bool m_valid;                      // TRUE if objects are valid.
+};
+
 //--------------------------------
 // This method is the constructor.
 //--------------------------------
@@ -27,6 +59,12 @@
 Enigma::World::World()
 {	
   m_filename.clear();
+  m_load_count = 0;
+  m_sort_count = 0;
+  m_load_index = 0;
+  m_load_size  = 0;
+  m_cancel     = false;
+  m_load_threads = 0;
   clear();
 }
 
@@ -42,10 +80,16 @@ void Enigma::World::clear()
   m_items.clear();
   m_teleporters.clear();
   m_description.clear();
+  m_chunks.clear();
+  m_failed_chunks.clear();
+  m_chunk_filename.clear();
+  m_hashed_filename.clear();
+  m_file_identity.clear();
   
   // Initialize instance variables.
   
-  m_savable = false;
+  m_savable   = false;
+  m_file_hash = 0;
 }
 
 //------------------------------------------------------------
@@ -134,6 +178,223 @@ void write_key_value_string(std::string& buffer,
 	}
 }
 
+//---------------------------------------------------------------------
+// This private function opens a file for reading.  A file compressed
+// with gzip (eg. "world.ewc.gz") is recognized by its magic number, and
+// a decompressor is inserted into the stream.  A Glib::Error exception
+// is thrown if the file cannot be opened.
+//---------------------------------------------------------------------
+// filename:   Name of file to be opened.
+// compressed: Set to TRUE if the file is compressed.
+// RETURN:     Stream of uncompressed file contents.
+//---------------------------------------------------------------------
+
+Glib::RefPtr<Gio::InputStream> open_file(const std::string& filename,
+                                         bool& compressed)
+{
+	Glib::RefPtr<Gio::File> file = Gio::File::create_for_path(filename);
+	Glib::RefPtr<Gio::FileInputStream> file_stream = file->read();
+
+	// Read the first two bytes for a gzip magic number, then return to
+	// the start of the file.
+
+	guchar magic[2];
+	gssize size = file_stream->read(magic, sizeof(magic));
+	file_stream->seek(0, Glib::SEEK_TYPE_SET);
+
+	compressed = (size == sizeof(magic))
+	          && (magic[0] == 0x1f)
+	          && (magic[1] == 0x8b);
+
+	if (compressed)
+	{
+		return Gio::ConverterInputStream::create(file_stream,
+			Gio::ZlibDecompressor::create(Gio::ZLIB_COMPRESSOR_FORMAT_GZIP));
+	}
+	else
+		return file_stream;
+}
+
+//---------------------------------------------------------------------
+// This private function appends data from a stream to a buffer, one
+// block at a time, until the buffer reaches a requested size, the
+// stream ends, or reading is cancelled.
+//---------------------------------------------------------------------
+// stream:   Stream to be read.
+// filedata: Buffer to receive the stream data.
+// size:     Requested buffer size.
+// cancel:   Set to TRUE (by another thread) to cancel reading.
+//---------------------------------------------------------------------
+
+void read_stream(const Glib::RefPtr<Gio::InputStream>& stream,
+                 std::string& filedata,
+                 gsize size,
+                 const std::atomic<bool>& cancel)
+{
+	char block[STREAM_BLOCK];
+	gssize count = 1;
+
+	while ((filedata.size() < size) && (count > 0) && !cancel)
+	{
+		count = stream->read(block,
+		                     std::min((gsize)sizeof(block),
+		                              size - filedata.size()));
+
+		if (count > 0)
+			filedata.append(block, count);
+	}
+}
+
+//---------------------------------------------------------------------
+// This private function appends data from a stream to a buffer until
+// the buffer contains the end of a world file header.
+//---------------------------------------------------------------------
+// stream:   Stream to be read.
+// filedata: Buffer to receive the stream data.
+// cancel:   Set to TRUE (by another thread) to cancel reading.
+// RETURN:   TRUE if the end of the header was found.
+//---------------------------------------------------------------------
+
+bool read_header(const Glib::RefPtr<Gio::InputStream>& stream,
+                 std::string& filedata,
+                 const std::atomic<bool>& cancel)
+{
+	static const std::string end_header = "end_header\n";
+	gsize size;
+
+	do
+	{
+		// Search the newly read block, including enough of the previous block
+		// to find a header ending that straddles both blocks.
+
+		size = filedata.size();
+		read_stream(stream, filedata, size + STREAM_BLOCK, cancel);
+
+		if (filedata.find(end_header,
+		                  (size > end_header.size()) ? size - end_header.size() : 0)
+		    != std::string::npos)
+		{
+			return true;
+		}
+	}
+	while (filedata.size() > size);
+
+	return false;
+}
+
+//---------------------------------------------------------------------
+// This private function creates a stream for writing a file.  If the
+// filename ends with ".gz", the data is compressed with gzip as it
+// streams into the file.  The file replacement is written to a
+// temporary file, which takes the place of the original file only once
+// the stream is closed.  A Glib::Error exception is thrown if the file
+// cannot be created.
+//---------------------------------------------------------------------
+// filename: Name of file to be written.
+// RETURN:   Stream of file contents.
+//---------------------------------------------------------------------
+
+Glib::RefPtr<Gio::OutputStream> create_file(const std::string& filename)
+{
+	Glib::RefPtr<Gio::File> file = Gio::File::create_for_path(filename);
+	Glib::RefPtr<Gio::OutputStream> stream = file->replace();
+
+	if (Glib::str_has_suffix(filename, ".gz"))
+	{
+		// Insert a compressor into the stream.
+
+		stream = Gio::ConverterOutputStream::create(stream,
+			Gio::ZlibCompressor::create(Gio::ZLIB_COMPRESSOR_FORMAT_GZIP, -1));
+	}
+
+	return stream;
+}
+
+//---------------------------------------------------------------------
+// This private function returns what identifies the present contents
+// of a file: its size and entity tag.  The entity tag of a local file
+// changes whenever the file is modified.
+//---------------------------------------------------------------------
+// filename: Name of file.
+// RETURN:   File identity, or an empty string if the file is missing.
+//---------------------------------------------------------------------
+
+std::string get_file_identity(const std::string& filename)
+{
+	try
+	{
+		Glib::RefPtr<Gio::FileInfo> info =
+			Gio::File::create_for_path(filename)->query_info(
+				G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_ETAG_VALUE);
+
+		return std::to_string(info->get_size()) + " " + info->get_etag().raw();
+	}
+	catch(Glib::Error error)
+	{
+		return std::string();
+	}
+}
+
+//---------------------------------------------------------------------
+// This private function writes buffers to a file.  If the filename
+// ends with ".gz", the data is compressed with gzip as it streams into
+// the file.
+//---------------------------------------------------------------------
+// filename: Name of file to be written.
+// header:   Buffer containing the file header.
+// body:     Buffer containing the file body.
+// RETURN:   TRUE if the file was written successfully.
+//---------------------------------------------------------------------
+
+bool write_file(const std::string& filename,
+                const std::string& header,
+                const std::string& body)
+{
+	try
+	{
+		Glib::RefPtr<Gio::OutputStream> stream = create_file(filename);
+
+		gsize written;
+		stream->write_all(header.data(), header.size(), written);
+		stream->write_all(body.data(), body.size(), written);
+		stream->close();
+	}
+	catch(Glib::Error error)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------
+// This private function returns TRUE if a filename has the extension of
+// a chunked world file (".ewci", optionally followed by ".gz").
+//---------------------------------------------------------------------
+// filename: Filename to be examined.
+// RETURN:   TRUE if the file is to use the chunked format.
+//---------------------------------------------------------------------
+
+bool is_chunked(const std::string& filename)
+{
+	return Glib::str_has_suffix(filename, ".ewci")
+	    || Glib::str_has_suffix(filename, ".ewci.gz");
+}
+
+//---------------------------------------------------------------------
+// This private function returns TRUE if a filename has the extension of
+// a JSON Lines text world file (".jsonl", optionally followed by ".gz").
+//---------------------------------------------------------------------
+// filename: Filename to be examined.
+// RETURN:   TRUE if the file is to use the JSON Lines format.
+//---------------------------------------------------------------------
+
+bool is_lines(const std::string& filename)
+{
+	return Glib::str_has_suffix(filename, ".jsonl")
+	    || Glib::str_has_suffix(filename, ".jsonl.gz");
+}
+
 //-------------------------------------------------------------------
 // This private function returns the number of bytes in a string line
 // of a line ending with the newline '\n' or \x00 characters.          
@@ -595,64 +856,260 @@ void extract_controller(const std::string& filedata,
 	}
 }
 
-//-------------------------------------------------------------
-// This method loads a game world from a file (.ewc extension).
-//-------------------------------------------------------------
-
-void Enigma::World::load()
-{	
-	// Clear old data in map, but retain the filename. 
+//--------------------------------------------------------------------
+// This private function skips over an object in file data, recording
+// only the information that is carried over to the next object (its
+// surface, rotation, position, active state and category).  It is
+// much faster than extract_object(), since no strings are copied.
+//--------------------------------------------------------------------
+// filedata: Keyvalue stream.
+// index:    KeyValue index.
+// object:   Reference to object state.
+// savable:  Reference to save Savable state.
+// RETURN:   FALSE if a signal name runs past the end of the file data.
+//--------------------------------------------------------------------
 
-	clear();
+bool scan_object(const std::string& filedata,
+                 guint& index,
+                 Enigma::Object& object,
+                 bool& savable)
+{
+	// Skip over the header keyvalue.  The calling function ensures the
+	// presence of a complete header.
 
-	// Load game world file.  Return if unsuccessful.
+	index += 2;
 
-	std::string filedata;
+	Enigma::World::Key group_state  = Enigma::World::Key::NONE;
+	Enigma::World::Key member_state = Enigma::World::Key::NONE;
+	Enigma::World::Key key;
+	guint8 value;
+	guint16 high_value;
+	bool done = false;
 
-	try
-	{
-		filedata = Glib::file_get_contents(m_filename);
-	}
-	catch(Glib::Error error)
+	while (((filedata.size() - index) >= 2) && !done)
 	{
-		return;
-	}
+		key = (Enigma::World::Key)filedata[index];
+		value = filedata[index + 1];
+		index += 2;
 
-	// Confirm that the first line of the game map file has the proper
-	// indentification code.
+		switch(key)
+		{
+			case Enigma::World::Key::SURFACE:
+				object.m_surface = (Enigma::Object::Direction)value;
+				group_state  = key;
+				member_state = key;
+				break;
 
-	if (!filedata.compare("ewc\n"))
-		return;
+			case Enigma::World::Key::ROTATION:
+				object.m_rotation = (Enigma::Object::Direction)value;
+				group_state  = key;
+				member_state = key;
+				break;
 
-	// Confirm that the file header has the correct ending.
+			case Enigma::World::Key::EAST:
+				object.m_position.m_east = (guint16)value;
+				group_state  = key;
+				member_state = key;
+				break;
 
-	bool end_header = false;
-	guint index = 0;
-	guint size  = 0;
+			case Enigma::World::Key::NORTH:
+				object.m_position.m_north = (guint16)value;
+				group_state  = key;
+				member_state = key;
+				break;
 
-	do
-	{
-	size = find_line(filedata, index);
+			case Enigma::World::Key::ABOVE:
+				object.m_position.m_above = (guint16)value;
+				group_state  = key;
+				member_state = key;
+				break;
 
-	if (filedata.compare( index, size, "end_header\n") == 0)
-	{
-		end_header = true;
-		break;
+			case Enigma::World::Key::ACTIVE:
+				object.m_active = (bool)value;
+				break;
+
+			case Enigma::World::Key::CATEGORY:
+				object.m_category = (Enigma::Object::Category)value;
+				break;
+
+			case Enigma::World::Key::BANK:
+				// Only a high byte added to a position is carried over.  One added
+				// to a teleporter arrival position is ignored.
+
+				high_value = (guint16)(value << 8);
+
+				if (member_state == group_state)
+				{
+					if (group_state == Enigma::World::Key::EAST)
+						object.m_position.m_east |= high_value;
+					else if (group_state == Enigma::World::Key::NORTH)
+						object.m_position.m_north |= high_value;
+					else if (group_state == Enigma::World::Key::ABOVE)
+						object.m_position.m_above |= high_value;
+				}
+
+				break;
+
+			case Enigma::World::Key::ARRIVAL:
+				member_state = key;
+				break;
+
+			case Enigma::World::Key::SENSE:
+			case Enigma::World::Key::STATE:
+			case Enigma::World::Key::VISIBILITY:
+			case Enigma::World::Key::PRESENCE:
+				// Skip over a signal name.  Value is the name's length.
+
+				if (value > (filedata.size() - index))
+					return false;
+
+				index += value;
+				break;
+
+			case Enigma::World::Key::SAVED:
+				savable = true;
+				break;
+
+			case Enigma::World::Key::OBJECT:
+			case Enigma::World::Key::TELEPORTER:
+			case Enigma::World::Key::PLAYER:
+			case Enigma::World::Key::ITEM:
+			case Enigma::World::Key::DESCRIPTION:
+			case Enigma::World::Key::CONTROLLER:
+			case Enigma::World::Key::END:
+				// An element keyvalue or array end keyvalue has been encountered.
+				// Move the array index back to this keyvalue before exiting.
+
+				index -= 2;
+				done = true;
+				break;
+
+			default:
+				break;
+		}
 	}
-	else
-		index += size;
+
+	return true;
+}
+
+//----------------------------------------------------------------------
+// This private function extracts all objects in a segment of file data.
+// Objects are added in file order to the segment's lists, which are
+// later appended to the world's lists.
+//----------------------------------------------------------------------
+// filedata: Keyvalue stream.
+// segment:  Segment to be extracted.
+// cancel:   Set to TRUE (by another thread) to cancel extraction.
+// progress: Byte count of extracted file data, advanced when done.
+//----------------------------------------------------------------------
+
+void extract_segment(const std::string& filedata,
+                     Segment& segment,
+                     const std::atomic<bool>& cancel,
+                     std::atomic<gsize>& progress)
+{
+	Enigma::Object object = segment.m_state;
+	guint index = segment.m_start;
+	Enigma::World::Key key;
+	bool savable;
+
+	segment.m_valid = true;
+
+	while (index < segment.m_end)
+	{
+		if (cancel)
+		{
+			segment.m_valid = false;
+			return;
+		}
+
+		// A Saved key was already noted when the segment was found.
+
+		key = (Enigma::World::Key)filedata.at(index);
+		extract_object(filedata, index, object, savable);
+
+		if  (((int)object.m_id >= (int)Enigma::Object::ID::TOTAL)
+			|| ((int)object.m_surface >= (int)Enigma::Object::Direction::TOTAL)
+			|| ((int)object.m_rotation >= (int)Enigma::Object::Direction::TOTAL))
+		{
+			segment.m_valid = false;
+			return;
+		}
+
+		if (key == Enigma::World::Key::ITEM)
+			segment.m_items.push_back(object);
+		else if (key == Enigma::World::Key::PLAYER)
+			segment.m_players.push_back(object);
+		else if (key == Enigma::World::Key::TELEPORTER)
+			segment.m_teleporters.push_back(object);
+		else
+			segment.m_objects.push_back(object);
 	}
-	while (size != 0);
 
-	// Exit if the end of the header was not found.
+	progress += segment.m_end - segment.m_start;
+}
 
-	if (!end_header)
-		return;
+//-------------------------------------------------------------------
+// This private function reads the location of a chunk from a chunked
+// world file header line, such as "chunk main 0 1024" or
+// "chunk level 3 1024 4096".  Chunk offsets are relative to the start
+// of the file body, just past the header.
+//-------------------------------------------------------------------
+// filedata: Buffer containing the header line.
+// index:    Index of the header line text just past "chunk ".
+// main:     Main chunk location.
+// levels:   Map of level chunk locations, keyed by Above position.
+//-------------------------------------------------------------------
 
-	// Skip over the header to the start of the map elements.
+void read_chunk(const std::string& filedata,
+                guint index,
+                Enigma::World::Chunk& main,
+                std::map<unsigned short, Enigma::World::Chunk>& levels)
+{
+	const gchar* text = filedata.c_str() + index;
+	gchar* next;
 
-	index += size;
+	if (filedata.compare(index, 5, "main ") == 0)
+	{
+		main.m_offset = g_ascii_strtoull(text + 5, &next, 10);
+		main.m_length = g_ascii_strtoull(next, &next, 10);
+	}
+	else if (filedata.compare(index, 6, "level ") == 0)
+	{
+		unsigned short above = (unsigned short)g_ascii_strtoull(text + 6,
+		                                                        &next,
+		                                                        10);
+
+		Enigma::World::Chunk& level = levels[above];
+		level.m_offset = g_ascii_strtoull(next, &next, 10);
+		level.m_length = g_ascii_strtoull(next, &next, 10);
+	}
+}
 
+//-----------------------------------------------------------------------
+// This private method extracts elements from a section of a keyvalue
+// array.  The section must end with an End keyvalue.  Structural objects
+// are added to the provided list, rather than the world's object list,
+// so that a level loaded from a chunked world file can be merged later.
+//
+// Since each object carries over information from the previous object,
+// the section is first scanned quickly to divide its objects into
+// segments, noting the carried information at the start of each.
+// Controllers and the description are extracted during this scan.
+// The segments are then extracted in parallel, and appended in order.
+//-----------------------------------------------------------------------
+// filedata: Buffer containing the keyvalue array.
+// index:    Index of the first keyvalue in the section.
+// end:      Index just past the last keyvalue in the section.
+// objects:  List to receive structural objects.
+// RETURN:   TRUE if the section contained valid data.
+//-----------------------------------------------------------------------
+
+bool Enigma::World::extract_elements(const std::string& filedata,
+                                     guint index,
+                                     guint end,
+                                     Enigma::ObjectList& objects)
+{
 	// Initialize an Object to receive keyvalue array information.
 
 	Enigma::Object object;
@@ -666,14 +1123,24 @@ void Enigma::World::load()
 	object.m_position.m_north = Enigma::Position::MINIMUM;
 	object.m_position.m_above = Enigma::Position::MINIMUM;
 
-	// Read information from the keyvalue array.
+	// Scan the keyvalue array.  A new segment begins after every
+	// SEGMENT_OBJECTS objects, or after any other element.  Loading
+	// progress counts each byte twice: once when scanned, and once when
+	// extracted.
+
+	std::list<Segment> segments;
+	Segment* segment = nullptr;
+	guint count      = 0;
+	guint scanned    = index;
+
+	m_load_size += 2 * (end - index);
 
 	bool valid_data = true;
 	bool done       = false;
 	Enigma::World::Key key;
 	guint8 value;
 
-	while (((filedata.size() - index) >= 2) && !done)
+	while (((end - index) >= 2) && !done)
 	{
 		// A complete keyvalue pair is available.  Read the keyvalue,
 		// but keep the keyvalue array index on the element header. 
@@ -690,39 +1157,43 @@ void Enigma::World::load()
 				// An Object, Teleporter, Item or Player element header has been
 				// encountered.
 
-				extract_object(filedata, index, object, m_savable);
-
-				if  (((int)object.m_id < (int)Enigma::Object::ID::TOTAL)
-					&& ((int)object.m_surface < (int)Enigma::Object::Direction::TOTAL)
-					&& ((int)object.m_rotation < (int)Enigma::Object::Direction::TOTAL))
-				{            
-					// The MapObject has been filled with valid data.  Add a new
-					// object to the appropriate list.
-
-					if (key == Enigma::World::Key::ITEM)
-						m_items.push_back(object);
-					else if (key == Enigma::World::Key::PLAYER)
-						m_players.push_back(object);
-					else if (key == Enigma::World::Key::TELEPORTER)
-						m_teleporters.push_back(object);
-					else
-						m_objects.push_back(object);
-				}
-				else
+				if ((segment == nullptr) || (count == SEGMENT_OBJECTS))
 				{
-					// The MapObject has some invalid data.  Force an exit with an
-					// invalid data error.
+					// Report progress, and stop if loading has been cancelled.
+
+					m_load_index += index - scanned;
+					scanned = index;
+
+					if (m_cancel)
+					{
+						valid_data = false;
+						done       = true;
+						break;
+					}
+
+					segments.emplace_back();
+					segment = &segments.back();
+					segment->m_start = index;
+					segment->m_state = object;
+					count = 0;
+				}
 
+				if (!scan_object(filedata, index, object, m_savable))
+				{
 					valid_data = false;
 					done       = true;
+					break;
 				}
 
+				segment->m_end = index;
+				++ count;
 				break;
 
 			case Enigma::World::Key::DESCRIPTION:
 				// A Description element header has been encountered.
 
 				extract_description(filedata, index, m_description);
+				segment = nullptr;
 				break;
 
 			case Enigma::World::Key::CONTROLLER:
@@ -730,13 +1201,14 @@ void Enigma::World::load()
 
 				m_controllers.emplace_back();
 				extract_controller(filedata, index, m_controllers.back());
+				segment = nullptr;
 				break;
 
 			case Enigma::World::Key::END:
 				// The end of the keyvalue array has been found.  Ensure it has
 				// the correct value, and is last in the keyvalue array.
 
-				if ((value != 0) || ((filedata.size() - index) != 2))
+				if ((value != 0) || ((end - index) != 2))
 				valid_data = false;
 
 				done = true;
@@ -750,616 +1222,2354 @@ void Enigma::World::load()
 				done       = true;
 				break;
 		}
+
+		// An element whose data runs past the end of the section is invalid.
+		// Stopping here also keeps the remaining byte count from wrapping.
+
+		if (index > end)
+		{
+			valid_data = false;
+			done       = true;
+		}
 	}
 
-	// If there was a data error, clear all saved data.  The game world file
-	// may be faulty.
+	if (!valid_data)
+		return false;
 
-	if (!valid_data)    
-		clear();
-}
+	m_load_index += end - scanned;
 
-//--------------------------------------------
-// This method saves the game world to a file.
-//--------------------------------------------
+	// Extract the segments, using one thread per processor core unless
+	// fewer are allowed.  Small sections with only one segment are
+	// extracted without a thread.
 
-void Enigma::World::save()
-{	
-	//-------------------------
-	// Write a game map header.
-	//-------------------------
+	std::vector<Segment*> work;
+
+	for (Segment& next : segments)
+		work.push_back(&next);
 
-	std::string filedata =
-	"ewc\n\
-format binary_byte 1.0\n\
-comment Enigma in the Wine Cellar 1.0 game world\n\
-comment Created by World in the Wine Cellar 1.0\n";
+	std::atomic<gsize> next_segment(0);
 
-	filedata.append("element object ");
-	filedata.append(std::to_string(m_objects.size()));
-	filedata.push_back('\n');
+	auto extract = [&]()
+	{
+		gsize number;
 
-	filedata.append("element teleporter ");
-	filedata.append(std::to_string(m_teleporters.size()));
-	filedata.push_back('\n');
+		while ((number = next_segment ++) < work.size())
+			extract_segment(filedata, *work[number], m_cancel, m_load_index);
+	};
 
-	filedata.append("element player ");
-	filedata.append(std::to_string(m_players.size()));
-	filedata.push_back('\n');
+	gsize threads = std::thread::hardware_concurrency();
 
-	filedata.append("element item ");
-	filedata.append(std::to_string(m_items.size()));
-	filedata.push_back('\n');
+	if (m_load_threads > 0)
+		threads = std::min(threads, (gsize)m_load_threads);
 
-	filedata.append("element description 1");
-	filedata.push_back('\n');
+	threads = std::min(threads, work.size());
 
-	filedata.append("element controller ");
-	filedata.append(std::to_string(m_controllers.size()));
-	filedata.push_back('\n');
+	if (threads <= 1)
+		extract();
+	else
+	{
+		std::vector<std::thread> pool;
 
-	filedata.append("end_header\n");
+		for (gsize thread = 0; thread < threads; ++ thread)
+			pool.emplace_back(extract);
 
-	//-------------------------------------
-	// Write KeyValues for all Controllers.
-	//-------------------------------------
+		for (std::thread& thread : pool)
+			thread.join();
+	}
 
-	std::list<Enigma::Controller>::iterator controller;
+	// Append the extracted objects in file order.  Each list notes whether
+	// its objects remain sorted.
 
-	for (controller = m_controllers.begin();
-	     controller != m_controllers.end();
-	     ++ controller)
+	for (Segment& next : segments)
 	{
-		// Add header for a map controller.
+		if (!next.m_valid)
+			return false;
 
-		write_key_value_string(filedata,
-			                     Enigma::World::Key::CONTROLLER,
-			                     (*controller).m_name);
+		objects.append(next.m_objects);
+		m_items.append(next.m_items);
+		m_players.append(next.m_players);
+		m_teleporters.append(next.m_teleporters);
+	}
 
-		// Write Main bytecode block.
+	return true;
+}
 
-		write_key_value_8bit(filedata,
-			                   Enigma::World::Key::CODE,
-			                   0);
+//----------------------------------------------------------------------
+// This private method sorts any object lists that were loaded out of
+// order.  World files written by this program are always sorted, so
+// this normally costs only the order checks made while loading.
+//----------------------------------------------------------------------
 
-		write_key_value_16bit(filedata,
-			                    Enigma::World::Key::LENGTH,
-			                    (*controller).m_main_code.size());
+void Enigma::World::sort_lists()
+{
+	if (m_objects.sort())
+		++ m_sort_count;
 
-		write_key_value_8bit(filedata,
-			                   Enigma::World::Key::DATA,
-			                   0);
+	if (m_players.sort())
+		++ m_sort_count;
 
-		filedata.append((*controller).m_main_code);
+	if (m_items.sort())
+		++ m_sort_count;
 
-		// Write Current bytecode block (same as Restart bytecode for
-		// new game maps).
+	if (m_teleporters.sort())
+		++ m_sort_count;
+}
 
-		write_key_value_8bit(filedata,
-			                   Enigma::World::Key::CURRENT,
-			                   0);
+//------------------------------------------------------------------
+// This private method records the hash of the data in a completely
+// read world file, so that save() can recognize unchanged data.
+//------------------------------------------------------------------
+// filedata: World file data, including the header.
+// index:    Index of the data just past the header.
+//------------------------------------------------------------------
 
-		write_key_value_16bit(filedata,
-			                    Enigma::World::Key::LENGTH,
-			                    (*controller).m_restart_code.size());
+void Enigma::World::hash_file(const std::string& filedata, guint index)
+{
+	// The header and the rest of the data are hashed separately, just as
+	// they are by save().
 
-		write_key_value_8bit(filedata,
-			                   Enigma::World::Key::DATA,
-			                   0);
+	Enigma::Hash hash;
+	hash.add(filedata.data(), index);
+	hash.add(filedata.data() + index, filedata.size() - index);
 
-		filedata.append((*controller).m_restart_code);
+	m_file_hash = hash.get();
+	m_hashed_filename = m_filename;
+	m_file_identity = get_file_identity(m_filename);
+}
 
-		// Write Saved bytecode block (same as Restart bytecode for
-		// new game maps).
+//--------------------------------------------------------------------
+// This method returns a hash of the world content, for identifying
+// content when caching results derived from it.  The object list
+// hashes are kept current as objects are inserted and removed, so
+// only the controllers and description are hashed here.  Levels not
+// yet loaded from a chunked world file are loaded first.
+//--------------------------------------------------------------------
+// RETURN: 64-bit hash value.
+//--------------------------------------------------------------------
+
+guint64 Enigma::World::hash()
+{
+	load_levels();
 
-		if (m_savable)
-		{
-			write_key_value_8bit(filedata,
-				                   Enigma::World::Key::SAVED,
-				                   0);
+	Enigma::Hash hash;
 
-			write_key_value_16bit(filedata,
-				                    Enigma::World::Key::LENGTH,
-				                   (*controller).m_restart_code.size());
+	hash.add(m_objects.hash());
+	hash.add(m_teleporters.hash());
+	hash.add(m_players.hash());
+	hash.add(m_items.hash());
 
-			write_key_value_8bit(filedata,
-				                   Enigma::World::Key::DATA,
-				                   0);
+	std::list<Enigma::Controller>::iterator controller;
 
-			filedata.append((*controller).m_restart_code);
-		}
+	for (controller = m_controllers.begin();
+	     controller != m_controllers.end();
+	     ++ controller)
+	{
+		hash.add((*controller).m_name);
+		hash.add((*controller).m_signal_names);
+		hash.add((*controller).m_restart_code);
+		hash.add((*controller).m_main_code);
+	}
 
-		// Write Restart bytecode block.
+	hash.add(m_description.raw());
+	hash.add((guint64)m_savable);
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::RESTART,
-		                     0);
+	return hash.get();
+}
 
-		write_key_value_16bit(filedata,
-		                      Enigma::World::Key::LENGTH,
-		                      (*controller).m_restart_code.size());
+//-------------------------------------------------------------------
+// This method loads a game world from a file (.ewc extension).  The
+// structural objects in an uncompressed chunked world file (.ewci
+// extension) are loaded one level at a time when first needed.
+//-------------------------------------------------------------------
+// RETURN: TRUE if the file was loaded successfully.
+//-------------------------------------------------------------------
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::DATA,
-		                     0);
+bool Enigma::World::load()
+{
+	// Clear old data in map, but retain the filename.
 
-		filedata.append((*controller).m_restart_code);
+	clear();
+	++ m_load_count;
 
-		// Add header for a packed array of controller signal names.
+	if (is_lines(m_filename))
+		return load_lines();
 
-		write_key_value_8bit(filedata,
-			                   Enigma::World::Key::SIGNAL,
-			                   0);
+	// Open the game world file, which may be compressed, and read the file
+	// header.  Return if unsuccessful.
 
-		// Add Length keyvalue.
+	std::string filedata;
+	Glib::RefPtr<Gio::InputStream> stream;
+	bool compressed;
 
-		write_key_value_16bit(filedata,
-			                    Enigma::World::Key::LENGTH,
-			                    (guint16)(*controller).m_signal_names.size());
+	try
+	{
+		stream = open_file(m_filename, compressed);
 
-		// Write Data keyvalue, followed by the packed array of signal names.
+		if (!read_header(stream, filedata, m_cancel))
+			return false;
+	}
+	catch(Glib::Error error)
+	{
+		return false;
+	}
 
-		write_key_value_8bit(filedata,
-			                   Enigma::World::Key::DATA,
-			                   0);
+	// Confirm that the first line of the game map file has the proper
+	// indentification code.
 
-		filedata.append((*controller).m_signal_names);
-	}
+	if (filedata.compare(0, 4, "ewc\n") != 0)
+		return false;
 
-	//--------------------------------------------
-	// Write KeyValues for all structural objects.
-	//--------------------------------------------
+	// Read the file header up to its ending, noting the file format and
+	// the location of any chunks.
 
-	// Set the initial East, North, and Above positions to their maximum,
-	// forcing an addition of position keyvalues for the first structural
-	// object (the first structural object cannot use the maximum value). 
+	bool end_header = false;
+	bool chunked    = false;
+	guint index     = 0;
+	guint size      = 0;
 
-	guint16 east  = Enigma::Position::MAXIMUM;
-	guint16 north = Enigma::Position::MAXIMUM;  	
-	guint16 above = Enigma::Position::MAXIMUM; 
+	Enigma::World::Chunk main = {0, 0};
+	std::map<unsigned short, Enigma::World::Chunk> levels;
 
-	std::list<Enigma::Object>::iterator object;
+	do
+	{
+	size = find_line(filedata, index);
 
-	for (object = m_objects.begin();
-	     object != m_objects.end();
-	     ++ object)
+	if (filedata.compare( index, size, "end_header\n") == 0)
 	{
-		// Add the header for a simple object.
+		end_header = true;
+		break;
+	}
+	else
+	{
+		if (filedata.compare( index, size, "format binary_chunked 1.0\n") == 0)
+			chunked = true;
+		else if (filedata.compare( index, 6, "chunk ") == 0)
+			read_chunk(filedata, index + 6, main, levels);
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::OBJECT,
-		                     (guint8)(*object).m_id);
+		index += size;
+	}
+	}
+	while (size != 0);
 
-		// Add a new East keyvalue if an object with a different position
-		// has been encountered.
+	// Exit if the end of the header was not found.
 
-		if ((*object).m_position.m_east != east)
-		{			
-			east = (*object).m_position.m_east;
+	if (!end_header)
+		return false;
 
-			write_key_value_16bit(filedata,
-			                      Enigma::World::Key::EAST,
-			                      east);
-		}
+	// Skip over the header to the start of the map elements.
 
-		// Add a new North keyvalue if an object with a different position
-		// has been encountered.
+	index += size;
 
-		if ((*object).m_position.m_north != north)
+	if (!chunked)
+	{
+		// Read the rest of the file, and extract all elements.
+
+		try
 		{
-			north = (*object).m_position.m_north;
+			read_stream(stream, filedata, G_MAXSIZE, m_cancel);
+		}
+		catch(Glib::Error error)
+		{
+			return false;
+		}
 
-			write_key_value_16bit(filedata,
-			                      Enigma::World::Key::NORTH,
-			                      north);
+		if (!extract_elements(filedata, index, filedata.size(), m_objects))
+		{
+			clear();
+			return false;
 		}
 
-		// Add a new Above keyvalue if an object with a different position
-		// has been encountered.
+		sort_lists();
+		hash_file(filedata, index);
+		return true;
+	}
 
-		if ((*object).m_position.m_above != above)
+	// A chunked world file has a main chunk containing all elements except
+	// structural objects, followed by one chunk of structural objects for
+	// each level.  A compressed file cannot be read at random, so it is read
+	// completely.  Otherwise, only the main chunk is read now.
+
+	try
+	{
+		if (compressed)
+			read_stream(stream, filedata, G_MAXSIZE, m_cancel);
+		else
+			read_stream(stream, filedata, index + main.m_offset + main.m_length, m_cancel);
+	}
+	catch(Glib::Error error)
+	{
+		return false;
+	}
+
+	if (((index + main.m_offset + main.m_length) > filedata.size())
+	    || !extract_elements(filedata,
+	                         index + main.m_offset,
+	                         index + main.m_offset + main.m_length,
+	                         m_objects))
+	{
+		clear();
+		return false;
+	}
+
+	std::map<unsigned short, Enigma::World::Chunk>::iterator level;
+
+	for (level = levels.begin(); level != levels.end(); ++ level)
+	{
+		if (compressed)
 		{
-			above = (*object).m_position.m_above;
+			// Extract the level's structural objects.  Since the levels are in
+			// ascending order, the object list remains sorted.
+
+			if (((index + (*level).second.m_offset + (*level).second.m_length)
+			     > filedata.size())
+			    || !extract_elements(filedata,
+			                         index + (*level).second.m_offset,
+			                         index + (*level).second.m_offset
+			                               + (*level).second.m_length,
+			                         m_objects))
+			{
+				clear();
+				return false;
+			}
+		}
+		else
+		{
+			// Record the file location of the level for loading later.
 
-			write_key_value_16bit(filedata,
-			                      Enigma::World::Key::ABOVE,
-			                      above);
+			(*level).second.m_offset += index;
+			m_chunks.insert(*level);
 		}
+	}
 
-		// Add a surface keyvalue.
+	// Only a completely read file has a file hash.
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::SURFACE,
-		                     (guint8)(*object).m_surface);
+	if (!compressed)
+		m_chunk_filename = m_filename;
+	else
+		hash_file(filedata, index);
 
-		// Add a rotation keyvalue.
+	sort_lists();
+	return true;
+}
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::ROTATION,
-		                     (guint8)(*object).m_rotation);
+//---------------------------------------------------------------------
+// This method loads the structural objects of one level from a chunked
+// world file, if they have not already been loaded.
+//---------------------------------------------------------------------
+// above:  Above position of level.
+// RETURN: FALSE if the level could not be loaded.
+//---------------------------------------------------------------------
 
-		// Add object state or signal keyvalues.
+bool Enigma::World::load_level(unsigned short above)
+{
+	std::map<unsigned short, Enigma::World::Chunk>::iterator level
+		= m_chunks.find(above);
 
-		write_key_value_string(filedata,
-		                       Enigma::World::Key::SENSE,
-		                       (*object).m_sense);
+	if (level == m_chunks.end())
+		return true;
 
-		write_key_value_string(filedata,
-		                       Enigma::World::Key::STATE,
-		                       (*object).m_state);
+	// The level is removed from the map of unloaded levels before reading,
+	// so that a faulty level is not read repeatedly while drawing.  A
+	// level that cannot be read is kept aside, so load_levels() can try
+	// it again rather than forget it.
 
-		write_key_value_string(filedata,
-		                       Enigma::World::Key::VISIBILITY,
-		                       (*object).m_visibility);
+	Enigma::World::Chunk chunk = (*level).second;
+	m_chunks.erase(level);
 
-		write_key_value_string(filedata,
-		                       Enigma::World::Key::PRESENCE,
-		                       (*object).m_presence);
-	}
+	std::string filedata;
 
-	//---------------------------------------------*
-	// Write KeyValues for all teleporter objects. *
-	//---------------------------------------------*
+	try
+	{
+		Glib::RefPtr<Gio::File> file = Gio::File::create_for_path(m_chunk_filename);
+		Glib::RefPtr<Gio::FileInputStream> stream = file->read();
 
-	for (object = m_teleporters.begin();
-	     object != m_teleporters.end();
-	     ++ object)
+		stream->seek(chunk.m_offset, Glib::SEEK_TYPE_SET);
+		read_stream(stream, filedata, chunk.m_length, m_cancel);
+	}
+	catch(Glib::Error error)
 	{
-		// Add header for a teleporter object.
+		m_failed_chunks[above] = chunk;
+		return false;
+	}
 
-		write_key_value_8bit(filedata,
-			                   Enigma::World::Key::TELEPORTER,
-			                   (guint8)(*object).m_id);
+	// Merge the level's objects into the sorted object list.
 
-		// Write departure surface keyvalue, and add arrival surface
-		// if it is not to be the player's current surface.
+	Enigma::ObjectList objects;
 
-		write_key_value_8bit(filedata,
-			                   Enigma::World::Key::SURFACE,
-			                   (guint8)(*object).m_surface);
+	if ((filedata.size() != chunk.m_length)
+	    || !extract_elements(filedata, 0, filedata.size(), objects))
+	{
+		m_failed_chunks[above] = chunk;
+		return false;
+	}
 
-		if ((*object).m_surface_arrival != Enigma::Object::Direction::NONE)
-		{
-			write_key_value_8bit(filedata,
-				                   Enigma::World::Key::ARRIVAL,
-				                   (guint8)(*object).m_surface_arrival);
-		}
+	if (objects.sort())
+		++ m_sort_count;
 
-		// Write departure rotation keyvalue, and add arrival rotation
-		// if it is not to be the player's current rotation.
+	m_objects.merge(objects);
+	return true;
+}
 
-		write_key_value_8bit(filedata,
-			                   Enigma::World::Key::ROTATION,
-			                   (guint8)(*object).m_rotation);
+//---------------------------------------------------------------------
+// This method loads all levels within a volume from a chunked world file.
+// Levels that could not be loaded before are tried again.
+//---------------------------------------------------------------------
+// volume: Volume of world whose levels are to be loaded.
+// RETURN: FALSE if any level could not be loaded.
+//---------------------------------------------------------------------
 
-		if ((*object).m_rotation_arrival != Enigma::Object::Direction::NONE)
+bool Enigma::World::load_levels(const Enigma::Volume& volume)
+{
+	bool valid_data = true;
+
+	std::map<unsigned short, Enigma::World::Chunk>::iterator failed
+		= m_failed_chunks.lower_bound(volume.m_WSB.m_above);
+
+	while ((failed != m_failed_chunks.end())
+	       && ((*failed).first <= volume.m_ENA.m_above))
+	{
+		m_chunks.insert(*failed);
+		failed = m_failed_chunks.erase(failed);
+	}
+
+	std::map<unsigned short, Enigma::World::Chunk>::iterator level
+		= m_chunks.lower_bound(volume.m_WSB.m_above);
+
+	while ((level != m_chunks.end())
+	       && ((*level).first <= volume.m_ENA.m_above))
+	{
+		// Loading the level removes it from the map.
+
+		unsigned short above = (*level).first;
+		++ level;
+
+		if (!load_level(above))
+			valid_data = false;
+	}
+
+	return valid_data;
+}
+
+//------------------------------------------------------------------
+// This method loads all remaining levels from a chunked world file.
+// Levels that could not be loaded before are tried again.
+//------------------------------------------------------------------
+// RETURN: FALSE if any level could not be loaded.
+//------------------------------------------------------------------
+
+bool Enigma::World::load_levels()
+{
+	bool valid_data = true;
+
+	m_chunks.insert(m_failed_chunks.begin(), m_failed_chunks.end());
+	m_failed_chunks.clear();
+
+	while (!m_chunks.empty())
+	{
+		if (!load_level((*m_chunks.begin()).first))
+			valid_data = false;
+	}
+
+	return valid_data;
+}
+
+//-----------------------------------------------------------------
+// This private function compares the positions of two objects, in
+// the order used by sorted object lists.
+//-----------------------------------------------------------------
+// first:  First object.
+// second: Second object.
+// RETURN: Negative if the first object is sorted first, positive if
+//         the second object is sorted first, or zero if both share
+//         the same position.
+//-----------------------------------------------------------------
+
+int compare_rooms(const Enigma::Object& first,
+                  const Enigma::Object& second)
+{
+	if (first.m_position.m_above != second.m_position.m_above)
+		return (first.m_position.m_above < second.m_position.m_above) ? -1 : 1;
+
+	if (first.m_position.m_north != second.m_position.m_north)
+		return (first.m_position.m_north < second.m_position.m_north) ? -1 : 1;
+
+	if (first.m_position.m_east != second.m_position.m_east)
+		return (first.m_position.m_east < second.m_position.m_east) ? -1 : 1;
+
+	return 0;
+}
+
+//-------------------------------------------------------------------
+// This private function notes the position of a changed object.  A
+// teleporter also changes the view of its arrival position.
+//-------------------------------------------------------------------
+// positions: List to receive positions.
+// object:    Changed object.
+//-------------------------------------------------------------------
+
+void note_position(std::list<Enigma::Position>& positions,
+                   const Enigma::Object& object)
+{
+	positions.push_back(object.m_position);
+
+	if (object.m_type == Enigma::Object::Type::TELEPORTER)
+		positions.push_back(object.m_position_arrival);
+}
+
+//----------------------------------------------------------------------
+// This private function updates a sorted object list to match another.
+// Both lists are traversed once together.  Objects sharing a position
+// are matched regardless of their order, so only objects actually
+// removed or inserted are changed.  These are then removed and merged
+// into the list in bulk.
+//----------------------------------------------------------------------
+// list:      Sorted object list to be updated.
+// latest:    Sorted object list to be matched.
+// positions: List to receive the positions of changed objects.
+// RETURN:    TRUE if the list was changed.
+//----------------------------------------------------------------------
+
+bool update_objects(Enigma::ObjectList& list,
+                    Enigma::ObjectList& latest,
+                    std::list<Enigma::Position>& positions)
+{
+	std::list<std::list<Enigma::Object>::iterator> removed;
+	std::list<Enigma::Object> inserted;
+
+	std::list<Enigma::Object>::iterator object = list.begin();
+	std::list<Enigma::Object>::iterator latest_object = latest.begin();
+	int order;
+
+	while ((object != list.end()) || (latest_object != latest.end()))
+	{
+		if (object == list.end())
+			order = 1;
+		else if (latest_object == latest.end())
+			order = -1;
+		else
+			order = compare_rooms(*object, *latest_object);
+
+		if (order < 0)
 		{
-			write_key_value_8bit(filedata,
-				                   Enigma::World::Key::ARRIVAL,
-				                   (guint8)(*object).m_rotation_arrival);
+			// The object is no longer in the world.
+
+			note_position(positions, *object);
+			removed.push_back(object);
+			++ object;
 		}
+		else if (order > 0)
+		{
+			// The object is new to the world.
 
-		// Write departure East location keyvalue, and add arrival East location
-		// if it is not to be the player's current East location.
+			note_position(positions, *latest_object);
+			inserted.push_back(*latest_object);
+			++ latest_object;
+		}
+		else
+		{
+			// Find the objects sharing this position in both lists.
 
-		write_key_value_16bit(filedata,
-			                    Enigma::World::Key::EAST,
-			                    (*object).m_position.m_east);
+			std::list<Enigma::Object>::iterator first = object;
+			std::list<Enigma::Object>::iterator last;
 
-		if ((*object).m_position_arrival.m_east != Enigma::Position::MAXIMUM)
+			while ((object != list.end())
+			       && (compare_rooms(*object, *first) == 0))
+			{
+				++ object;
+			}
+
+			std::vector<bool> matched(std::distance(first, object), false);
+			guint index;
+
+			// Match each latest object with an unmatched object that is the
+			// same.  An unmatched latest object is new to the world.
+
+			while ((latest_object != latest.end())
+			       && (compare_rooms(*latest_object, *first) == 0))
+			{
+				for (last = first, index = 0; last != object; ++ last, ++ index)
+				{
+					if (!matched[index] && (*last == *latest_object))
+					{
+						matched[index] = true;
+						break;
+					}
+				}
+
+				if (last == object)
+				{
+					note_position(positions, *latest_object);
+					inserted.push_back(*latest_object);
+				}
+
+				++ latest_object;
+			}
+
+			// Any objects still unmatched are no longer in the world.
+
+			for (last = first, index = 0; last != object; ++ last, ++ index)
+			{
+				if (!matched[index])
+				{
+					note_position(positions, *last);
+					removed.push_back(last);
+				}
+			}
+		}
+	}
+
+	// Apply the changes.  The inserted objects were found in sorted order,
+	// so they can be merged directly.
+
+	bool updated = !(removed.empty() && inserted.empty());
+	std::list<Enigma::Object> buffer;
+
+	list.remove(removed, buffer);
+	list.merge(inserted);
+
+	return updated;
+}
+
+//---------------------------------------------------------------------
+// This method returns the levels of a chunked world file that have not
+// been loaded yet.
+//---------------------------------------------------------------------
+// RETURN: Above positions of levels not loaded.
+//---------------------------------------------------------------------
+
+std::set<unsigned short> Enigma::World::get_unloaded_levels() const
+{
+	std::set<unsigned short> levels;
+
+	for (const auto& level : m_chunks)
+		levels.insert(level.first);
+
+	for (const auto& level : m_failed_chunks)
+		levels.insert(level.first);
+
+	return levels;
+}
+
+//---------------------------------------------------------------------
+// This method returns TRUE if the world file may differ from the one
+// last loaded or saved.  A file this program has just saved is left
+// with the size and entity tag recorded when it was written.
+//---------------------------------------------------------------------
+// RETURN: TRUE if the file has been changed.
+//---------------------------------------------------------------------
+
+bool Enigma::World::is_file_changed() const
+{
+	return m_file_identity.empty()
+	       || (m_hashed_filename != m_filename.raw())
+	       || (get_file_identity(m_filename) != m_file_identity);
+}
+
+//----------------------------------------------------------------------
+// This method loads a changed world file into this empty world, so it
+// can be compared with the current world by reload().  The levels of a
+// chunked world file that are loaded in the current world are loaded
+// here too.  Levels not yet loaded in either world remain unloaded in
+// both, and are read from the new file when needed.  The current world
+// is not used, so this may be called on another thread.
+//----------------------------------------------------------------------
+// unloaded: Levels not yet loaded in the current world.
+// RETURN:   TRUE if the file was loaded.
+//----------------------------------------------------------------------
+
+bool Enigma::World::load_latest(const std::set<unsigned short>& unloaded)
+{
+	if (!load())
+		return false;
+
+	std::map<unsigned short, Enigma::World::Chunk>::iterator level
+		= m_chunks.begin();
+
+	while (level != m_chunks.end())
+	{
+		unsigned short above = (*level).first;
+		++ level;
+
+		if ((unloaded.find(above) == unloaded.end()) && !load_level(above))
+			return false;
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------------------
+// This method applies a world file that has been changed by another
+// program.  Rather than clearing the world, the file is loaded
+// separately by load_latest() and compared with the world, and only the
+// differences are applied.  Objects and controllers left unchanged are
+// not disturbed, so viewers need only redraw the changed positions.
+//----------------------------------------------------------------------
+// latest:  World loaded from the changed file.  Its lists are emptied.
+// changes: Changes made to the world.
+//----------------------------------------------------------------------
+
+void Enigma::World::reload(Enigma::World& latest,
+                           Enigma::World::Changes& changes)
+{
+	changes.m_positions.clear();
+	changes.m_lists       = false;
+	changes.m_controllers = false;
+	changes.m_description = false;
+
+	// A file with the same data as the one last loaded or saved needs no
+	// comparison.
+
+	bool same = (latest.m_file_hash != 0)
+	            && (latest.m_file_hash == m_file_hash)
+	            && (latest.m_hashed_filename == m_hashed_filename);
+
+	m_file_identity = latest.m_file_identity;
+
+	if (same)
+		return;
+
+	m_chunks = latest.m_chunks;
+	m_failed_chunks = latest.m_failed_chunks;
+	m_chunk_filename = latest.m_chunk_filename;
+	m_file_hash = latest.m_file_hash;
+	m_hashed_filename = latest.m_hashed_filename;
+
+	// Apply changes to the object lists.
+
+	update_objects(m_objects, latest.m_objects, changes.m_positions);
+
+	if (update_objects(m_teleporters, latest.m_teleporters, changes.m_positions))
+		changes.m_lists = true;
+
+	if (update_objects(m_players, latest.m_players, changes.m_positions))
+		changes.m_lists = true;
+
+	if (update_objects(m_items, latest.m_items, changes.m_positions))
+		changes.m_lists = true;
+
+	// Remove controllers no longer in the world, and update the others in
+	// place.  New controllers are added to the end of the list.
+
+	std::list<Enigma::Controller>::iterator controller = m_controllers.begin();
+	std::list<Enigma::Controller>::iterator latest_controller;
+
+	while (controller != m_controllers.end())
+	{
+		for (latest_controller = latest.m_controllers.begin();
+		     latest_controller != latest.m_controllers.end();
+		     ++ latest_controller)
 		{
-			write_key_value_16bit(filedata,
-				                    Enigma::World::Key::ARRIVAL,
-				                    (*object).m_position_arrival.m_east);
+			if ((*latest_controller).m_name == (*controller).m_name)
+				break;
 		}
 
-		// Write departure North location keyvalue, and add arrival North location
-		// if it is not to be the player's current North location.
+		if (latest_controller == latest.m_controllers.end())
+		{
+			controller = m_controllers.erase(controller);
+			changes.m_controllers = true;
+		}
+		else
+		{
+			if (!(*controller == *latest_controller))
+			{
+				*controller = *latest_controller;
+				changes.m_controllers = true;
+			}
+
+			latest.m_controllers.erase(latest_controller);
+			++ controller;
+		}
+	}
+
+	if (!latest.m_controllers.empty())
+	{
+		m_controllers.splice(m_controllers.end(), latest.m_controllers);
+		changes.m_controllers = true;
+	}
+
+	// Update the description and world settings.
+
+	if ((m_description != latest.m_description)
+	    || (m_savable != latest.m_savable))
+	{
+		m_description = latest.m_description;
+		m_savable = latest.m_savable;
+		changes.m_description = true;
+	}
+}
+
+//----------------------------------------------------------
+// This private method writes keyvalues for all controllers.
+//----------------------------------------------------------
+// filedata: Destination buffer.
+//----------------------------------------------------------
+
+void Enigma::World::save_controllers(std::string& filedata)
+{
+	std::list<Enigma::Controller>::iterator controller;
+
+	for (controller = m_controllers.begin();
+	     controller != m_controllers.end();
+	     ++ controller)
+	{
+		// Add header for a map controller.
+
+		write_key_value_string(filedata,
+			                     Enigma::World::Key::CONTROLLER,
+			                     (*controller).m_name);
+
+		// Write Main bytecode block.
+
+		write_key_value_8bit(filedata,
+			                   Enigma::World::Key::CODE,
+			                   0);
 
 		write_key_value_16bit(filedata,
-			                    Enigma::World::Key::NORTH,
-			                    (*object).m_position.m_north);
+			                    Enigma::World::Key::LENGTH,
+			                    (*controller).m_main_code.size());
 
-		if ((*object).m_position_arrival.m_north != Enigma::Position::MAXIMUM)
+		write_key_value_8bit(filedata,
+			                   Enigma::World::Key::DATA,
+			                   0);
+
+		filedata.append((*controller).m_main_code);
+
+		// Write Current bytecode block (same as Restart bytecode for
+		// new game maps).
+
+		write_key_value_8bit(filedata,
+			                   Enigma::World::Key::CURRENT,
+			                   0);
+
+		write_key_value_16bit(filedata,
+			                    Enigma::World::Key::LENGTH,
+			                    (*controller).m_restart_code.size());
+
+		write_key_value_8bit(filedata,
+			                   Enigma::World::Key::DATA,
+			                   0);
+
+		filedata.append((*controller).m_restart_code);
+
+		// Write Saved bytecode block (same as Restart bytecode for
+		// new game maps).
+
+		if (m_savable)
 		{
+			write_key_value_8bit(filedata,
+				                   Enigma::World::Key::SAVED,
+				                   0);
+
 			write_key_value_16bit(filedata,
-					                  Enigma::World::Key::ARRIVAL,
-					                  (*object).m_position_arrival.m_north);
+				                    Enigma::World::Key::LENGTH,
+				                   (*controller).m_restart_code.size());
+
+			write_key_value_8bit(filedata,
+				                   Enigma::World::Key::DATA,
+				                   0);
+
+			filedata.append((*controller).m_restart_code);
 		}
 
-		// Write departure Above location keyvalue, adding arrival Above location
-		// if it is not to be the player's current Above location.
+		// Write Restart bytecode block.
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::RESTART,
+		                     0);
 
 		write_key_value_16bit(filedata,
-			                    Enigma::World::Key::ABOVE,
-			                    (*object).m_position.m_above);
+		                      Enigma::World::Key::LENGTH,
+		                      (*controller).m_restart_code.size());
 
-		if ((*object).m_position_arrival.m_above != Enigma::Position::MAXIMUM)
-		{           
-			write_key_value_16bit(filedata,
-				                    Enigma::World::Key::ARRIVAL,
-				                    (*object).m_position_arrival.m_above);
-		}
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::DATA,
+		                     0);
 
-			// Add object state or signal keyvalues.
+		filedata.append((*controller).m_restart_code);
 
-			write_key_value_string(filedata,
-				                     Enigma::World::Key::SENSE,
-				                     (*object).m_sense);
+		// Add header for a packed array of controller signal names.
 
-			write_key_value_string(filedata,
-				                     Enigma::World::Key::STATE,
-				                     (*object).m_state);
+		write_key_value_8bit(filedata,
+			                   Enigma::World::Key::SIGNAL,
+			                   0);
 
-			write_key_value_string(filedata,
-				                     Enigma::World::Key::VISIBILITY,
-				                     (*object).m_visibility);
+		// Add Length keyvalue.
+
+		write_key_value_16bit(filedata,
+			                    Enigma::World::Key::LENGTH,
+			                    (guint16)(*controller).m_signal_names.size());
+
+		// Write Data keyvalue, followed by the packed array of signal names.
+
+		write_key_value_8bit(filedata,
+			                   Enigma::World::Key::DATA,
+			                   0);
+
+		filedata.append((*controller).m_signal_names);
+	}
+}
+
+//----------------------------------------------------------------------
+// This private method writes keyvalues for a run of structural objects.
+//----------------------------------------------------------------------
+// filedata: Destination buffer.
+// first:    First object to be written.
+// last:     Object just past the last object to be written.
+//----------------------------------------------------------------------
+
+void Enigma::World::save_objects(std::string& filedata,
+                                 std::list<Enigma::Object>::iterator first,
+                                 std::list<Enigma::Object>::iterator last)
+{
+	// Set the initial East, North, and Above positions to their maximum,
+	// forcing an addition of position keyvalues for the first structural
+	// object (the first structural object cannot use the maximum value). 
+
+	guint16 east  = Enigma::Position::MAXIMUM;
+	guint16 north = Enigma::Position::MAXIMUM;  	
+	guint16 above = Enigma::Position::MAXIMUM; 
+
+	std::list<Enigma::Object>::iterator object;
+
+	for (object = first;
+	     object != last;
+	     ++ object)
+	{
+		// Add the header for a simple object.
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::OBJECT,
+		                     (guint8)(*object).m_id);
+
+		// Add a new East keyvalue if an object with a different position
+		// has been encountered.
+
+		if ((*object).m_position.m_east != east)
+		{			
+			east = (*object).m_position.m_east;
+
+			write_key_value_16bit(filedata,
+			                      Enigma::World::Key::EAST,
+			                      east);
+		}
+
+		// Add a new North keyvalue if an object with a different position
+		// has been encountered.
+
+		if ((*object).m_position.m_north != north)
+		{
+			north = (*object).m_position.m_north;
+
+			write_key_value_16bit(filedata,
+			                      Enigma::World::Key::NORTH,
+			                      north);
+		}
+
+		// Add a new Above keyvalue if an object with a different position
+		// has been encountered.
+
+		if ((*object).m_position.m_above != above)
+		{
+			above = (*object).m_position.m_above;
+
+			write_key_value_16bit(filedata,
+			                      Enigma::World::Key::ABOVE,
+			                      above);
+		}
+
+		// Add a surface keyvalue.
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::SURFACE,
+		                     (guint8)(*object).m_surface);
+
+		// Add a rotation keyvalue.
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::ROTATION,
+		                     (guint8)(*object).m_rotation);
+
+		// Add object state or signal keyvalues.
+
+		write_key_value_string(filedata,
+		                       Enigma::World::Key::SENSE,
+		                       (*object).m_sense);
+
+		write_key_value_string(filedata,
+		                       Enigma::World::Key::STATE,
+		                       (*object).m_state);
+
+		write_key_value_string(filedata,
+		                       Enigma::World::Key::VISIBILITY,
+		                       (*object).m_visibility);
+
+		write_key_value_string(filedata,
+		                       Enigma::World::Key::PRESENCE,
+		                       (*object).m_presence);
+	}
+}
+
+//-----------------------------------------------------------------
+// This private method writes keyvalues for all teleporter objects.
+//-----------------------------------------------------------------
+// filedata: Destination buffer.
+//-----------------------------------------------------------------
+
+void Enigma::World::save_teleporters(std::string& filedata)
+{
+	std::list<Enigma::Object>::iterator object;
+
+	for (object = m_teleporters.begin();
+	     object != m_teleporters.end();
+	     ++ object)
+	{
+		// Add header for a teleporter object.
+
+		write_key_value_8bit(filedata,
+			                   Enigma::World::Key::TELEPORTER,
+			                   (guint8)(*object).m_id);
+
+		// Write departure surface keyvalue, and add arrival surface
+		// if it is not to be the player's current surface.
+
+		write_key_value_8bit(filedata,
+			                   Enigma::World::Key::SURFACE,
+			                   (guint8)(*object).m_surface);
+
+		if ((*object).m_surface_arrival != Enigma::Object::Direction::NONE)
+		{
+			write_key_value_8bit(filedata,
+				                   Enigma::World::Key::ARRIVAL,
+				                   (guint8)(*object).m_surface_arrival);
+		}
+
+		// Write departure rotation keyvalue, and add arrival rotation
+		// if it is not to be the player's current rotation.
+
+		write_key_value_8bit(filedata,
+			                   Enigma::World::Key::ROTATION,
+			                   (guint8)(*object).m_rotation);
+
+		if ((*object).m_rotation_arrival != Enigma::Object::Direction::NONE)
+		{
+			write_key_value_8bit(filedata,
+				                   Enigma::World::Key::ARRIVAL,
+				                   (guint8)(*object).m_rotation_arrival);
+		}
+
+		// Write departure East location keyvalue, and add arrival East location
+		// if it is not to be the player's current East location.
+
+		write_key_value_16bit(filedata,
+			                    Enigma::World::Key::EAST,
+			                    (*object).m_position.m_east);
+
+		if ((*object).m_position_arrival.m_east != Enigma::Position::MAXIMUM)
+		{
+			write_key_value_16bit(filedata,
+				                    Enigma::World::Key::ARRIVAL,
+				                    (*object).m_position_arrival.m_east);
+		}
+
+		// Write departure North location keyvalue, and add arrival North location
+		// if it is not to be the player's current North location.
+
+		write_key_value_16bit(filedata,
+			                    Enigma::World::Key::NORTH,
+			                    (*object).m_position.m_north);
+
+		if ((*object).m_position_arrival.m_north != Enigma::Position::MAXIMUM)
+		{
+			write_key_value_16bit(filedata,
+					                  Enigma::World::Key::ARRIVAL,
+					                  (*object).m_position_arrival.m_north);
+		}
+
+		// Write departure Above location keyvalue, adding arrival Above location
+		// if it is not to be the player's current Above location.
+
+		write_key_value_16bit(filedata,
+			                    Enigma::World::Key::ABOVE,
+			                    (*object).m_position.m_above);
+
+		if ((*object).m_position_arrival.m_above != Enigma::Position::MAXIMUM)
+		{           
+			write_key_value_16bit(filedata,
+				                    Enigma::World::Key::ARRIVAL,
+				                    (*object).m_position_arrival.m_above);
+		}
+
+			// Add object state or signal keyvalues.
+
+			write_key_value_string(filedata,
+				                     Enigma::World::Key::SENSE,
+				                     (*object).m_sense);
+
+			write_key_value_string(filedata,
+				                     Enigma::World::Key::STATE,
+				                     (*object).m_state);
+
+			write_key_value_string(filedata,
+				                     Enigma::World::Key::VISIBILITY,
+				                     (*object).m_visibility);
+
+			write_key_value_string(filedata,
+				                     Enigma::World::Key::PRESENCE,
+				                     (*object).m_presence);
+	}
+}
+
+//-------------------------------------------------------------
+// This private method writes keyvalues for all player objects.
+//-------------------------------------------------------------
+// filedata: Destination buffer.
+//-------------------------------------------------------------
+
+void Enigma::World::save_players(std::string& filedata)
+{
+	std::list<Enigma::Object>::iterator object;
+
+	for (object = m_players.begin();
+	     object != m_players.end();
+	     ++ object)
+	{
+		// Add header for a player object.
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::PLAYER,
+		                     (guint8)(*object).m_id);
+
+		// Write current, saved, and restart surface keyvalues.
+		// All have the same value.
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::SURFACE,
+		                     (guint8)(*object).m_surface);
+
+		if (m_savable)
+		{
+			write_key_value_8bit(filedata,
+			                     Enigma::World::Key::SAVED,
+			                     (guint8)(*object).m_surface);
+		}
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::RESTART,
+		                     (guint8)(*object).m_surface);
+
+		// Write current, saved, and restart rotation keyvalues.
+		// All have the same value.
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::ROTATION,
+		                     (guint8)(*object).m_rotation);
+
+		if (m_savable)
+		{
+			write_key_value_8bit(filedata,
+			                     Enigma::World::Key::SAVED,
+			                     (guint8)(*object).m_rotation);
+		}
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::RESTART,
+		                     (guint8)(*object).m_rotation);
+
+		// Write current, saved, and restart East location keyvalues.
+		// All have the same value.
+
+		write_key_value_16bit(filedata,
+		                      Enigma::World::Key::EAST,
+		                      (*object).m_position.m_east);
+
+		if (m_savable)
+		{
+			write_key_value_16bit(filedata,
+			                      Enigma::World::Key::SAVED,
+			                      (*object).m_position.m_east);
+		} 
+
+		write_key_value_16bit(filedata,
+		                      Enigma::World::Key::RESTART,
+		                      (*object).m_position.m_east);
+
+		// Write current, saved, and restart North location keyvalues.
+		// All have the same value.
+
+		write_key_value_16bit(filedata,
+		                      Enigma::World::Key::NORTH,
+		                      (*object).m_position.m_north);
+
+		if (m_savable)
+		{
+			write_key_value_16bit(filedata,
+			                      Enigma::World::Key::SAVED,
+			                      (*object).m_position.m_north);
+		}
+
+		write_key_value_16bit(filedata,
+		                      Enigma::World::Key::RESTART,
+		                      (*object).m_position.m_north);
+
+		// Write current, saved, and restart Above location keyvalues.
+		// All have the same value.
+
+		write_key_value_16bit(filedata,
+		                      Enigma::World::Key::ABOVE,
+		                      (*object).m_position.m_above);
+
+		if (m_savable)
+		{
+			write_key_value_16bit(filedata,
+			                      Enigma::World::Key::SAVED,
+			                      (*object).m_position.m_above);
+		}
+
+		write_key_value_16bit(filedata,
+		                      Enigma::World::Key::RESTART,
+		                      (*object).m_position.m_above);
+
+		// Add current, saved, and restart Active state keyvalues.
+		// All have the same value.
+
+		write_key_value_boolean(filedata,
+			                      Enigma::World::Key::ACTIVE,
+			                      (*object).m_active);
+
+		if (m_savable)
+		{
+			write_key_value_boolean(filedata,
+				                      Enigma::World::Key::SAVED,
+				                      (*object).m_active);
+		}
+
+		write_key_value_boolean(filedata,
+		                        Enigma::World::Key::RESTART,
+		                        (*object).m_active);
+
+		// Add object state or signal keyvalues.  Player objects
+		// do not have a Sense state or signal.
+
+		write_key_value_string(filedata,
+		                       Enigma::World::Key::STATE,
+		                       (*object).m_state);
+
+		write_key_value_string(filedata,
+		                       Enigma::World::Key::VISIBILITY,
+		                       (*object).m_visibility);
+
+		write_key_value_string(filedata,
+		                       Enigma::World::Key::PRESENCE,
+		                       (*object).m_presence);
+	}
+}
+
+//-----------------------------------------------------------
+// This private method writes keyvalues for all item objects.
+//-----------------------------------------------------------
+// filedata: Destination buffer.
+//-----------------------------------------------------------
+
+void Enigma::World::save_items(std::string& filedata)
+{
+	std::list<Enigma::Object>::iterator object;
+
+	for (object = m_items.begin();
+	     object != m_items.end();
+	     ++ object)
+	{
+		// Add header for an item object.
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::ITEM,
+		                     (guint8)(*object).m_id);
+
+		// Write surface.
+
+		write_key_value_8bit(filedata,
+		                      Enigma::World::Key::SURFACE,
+		                      (guint8)(*object).m_surface);
+
+		// Write rotation.
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::ROTATION,
+		                     (guint8)(*object).m_rotation);
+
+		// Write location.
+
+		write_key_value_16bit(filedata,
+		                      Enigma::World::Key::EAST,
+		                      (*object).m_position.m_east);
+
+		write_key_value_16bit(filedata,
+		                      Enigma::World::Key::NORTH,
+		                      (*object).m_position.m_north);
+
+		write_key_value_16bit(filedata,
+		                      Enigma::World::Key::ABOVE,
+		                      (*object).m_position.m_above);
+
+		// Write category.
+
+		write_key_value_8bit(filedata,
+		                     Enigma::World::Key::CATEGORY,
+		                     (guint8)(*object).m_category);
+
+		// Add current, saved, and restart active state keyvalues.
+		// All items begin as active (not yet found).
+
+		write_key_value_boolean(filedata,
+		                        Enigma::World::Key::ACTIVE,
+		                        true);
+
+		if (m_savable)
+		{
+			write_key_value_boolean(filedata,
+			                        Enigma::World::Key::SAVED,
+			                        true);
+		}
+
+		write_key_value_boolean(filedata,
+		                        Enigma::World::Key::RESTART,
+		                        true);
+
+		// Add object state or signal keyvalues.  Item objects
+		// do not have a Sense state or signal.
+
+		write_key_value_string(filedata,
+		                       Enigma::World::Key::STATE,
+		                       (*object).m_state);
+
+		write_key_value_string(filedata,
+		                       Enigma::World::Key::VISIBILITY,
+		                       (*object).m_visibility);
+
+		write_key_value_string(filedata,
+		                       Enigma::World::Key::PRESENCE,
+		                       (*object).m_presence);
+	}
+}
+
+//----------------------------------------------------------------
+// This private method writes keyvalues for the world description.
+//----------------------------------------------------------------
+// filedata: Destination buffer.
+//----------------------------------------------------------------
+
+void Enigma::World::save_description(std::string& filedata)
+{
+	// Add header for a description.
+
+	write_key_value_8bit(filedata,
+	                     Enigma::World::Key::DESCRIPTION,
+	                     (guint8)Enigma::World::Language::ENGLISH);
+
+	// Add description length keyvalue.
+
+	write_key_value_16bit(filedata,
+	                      Enigma::World::Key::LENGTH,
+	                      (guint16)m_description.bytes());
+
+	// Write data keyvalue, followed by description in UTF-8 format.
+
+	write_key_value_8bit(filedata,
+	                     Enigma::World::Key::DATA,
+	                     0);
+
+	filedata.append(m_description);
+}
+
+//------------------------------------------------------------------
+// This method saves the game world to a file.  If the filename has
+// a ".ewci" extension, a chunked world file is written, with the
+// structural objects of each level in a separate chunk.
+//------------------------------------------------------------------
+// RETURN: TRUE if the file was saved successfully.
+//------------------------------------------------------------------
+
+bool Enigma::World::save()
+{
+	// Load any levels not yet read from a chunked world file, since the
+	// file may be about to be replaced.  A level that cannot be read would
+	// be lost, so the file is left alone.
+
+	if (!load_levels())
+		return false;
+
+	if (is_lines(m_filename))
+		return save_lines();
+
+	bool chunked = is_chunked(m_filename);
+
+	//-------------------------
+	// Write a game map header.
+	//-------------------------
+
+	std::string header = "ewc\n";
+
+	if (chunked)
+		header.append("format binary_chunked 1.0\n");
+	else
+		header.append("format binary_byte 1.0\n");
+
+	header.append(
+	"comment Enigma in the Wine Cellar 1.0 game world\n\
+comment Created by World in the Wine Cellar 1.0\n");
+
+	header.append("element object ");
+	header.append(std::to_string(m_objects.size()));
+	header.push_back('\n');
+
+	header.append("element teleporter ");
+	header.append(std::to_string(m_teleporters.size()));
+	header.push_back('\n');
+
+	header.append("element player ");
+	header.append(std::to_string(m_players.size()));
+	header.push_back('\n');
+
+	header.append("element item ");
+	header.append(std::to_string(m_items.size()));
+	header.push_back('\n');
+
+	header.append("element description 1");
+	header.push_back('\n');
+
+	header.append("element controller ");
+	header.append(std::to_string(m_controllers.size()));
+	header.push_back('\n');
+
+	//--------------------------
+	// Write the keyvalue array.
+	//--------------------------
+
+	std::string body;
+
+	if (!chunked)
+	{
+		save_controllers(body);
+		save_objects(body, m_objects.begin(), m_objects.end());
+		save_teleporters(body);
+		save_players(body);
+		save_items(body);
+		save_description(body);
+
+		write_key_value_8bit(body,
+		                     Enigma::World::Key::END,
+		                     0);
+	}
+	else
+	{
+		// Write the main chunk, containing all elements except structural
+		// objects.
+
+		save_controllers(body);
+		save_teleporters(body);
+		save_players(body);
+		save_items(body);
+		save_description(body);
+
+		write_key_value_8bit(body,
+		                     Enigma::World::Key::END,
+		                     0);
+
+		header.append("chunk main 0 ");
+		header.append(std::to_string(body.size()));
+		header.push_back('\n');
+
+		// Write a chunk of structural objects for each level.  Each chunk has
+		// its own keyvalue array terminator.
+
+		std::list<Enigma::Object>::iterator first = m_objects.begin();
+		std::list<Enigma::Object>::iterator last;
+		gsize offset;
+
+		while (first != m_objects.end())
+		{
+			last = first;
+
+			while ((last != m_objects.end())
+			       && ((*last).m_position.m_above == (*first).m_position.m_above))
+			{
+				++ last;
+			}
+
+			offset = body.size();
+			save_objects(body, first, last);
+
+			write_key_value_8bit(body,
+			                     Enigma::World::Key::END,
+			                     0);
+
+			header.append("chunk level ");
+			header.append(std::to_string((*first).m_position.m_above));
+			header.push_back(' ');
+			header.append(std::to_string(offset));
+			header.push_back(' ');
+			header.append(std::to_string(body.size() - offset));
+			header.push_back('\n');
+
+			first = last;
+		}
+	}
+
+	header.append("end_header\n");
+
+	// Skip writing if the file already contains this data, as when it was
+	// loaded and saved again without changes.  The file must still be the
+	// one that was read or written, since it may have been deleted or
+	// replaced since.
+
+	Enigma::Hash hash;
+	hash.add(header.data(), header.size());
+	hash.add(body.data(), body.size());
+
+	if ((m_file_hash == hash.get())
+	    && (m_hashed_filename == m_filename.raw())
+	    && !m_file_identity.empty()
+	    && (get_file_identity(m_filename) == m_file_identity))
+	{
+		return true;
+	}
+
+	// Write the file data to the file, compressing it if the filename
+	// has a ".gz" extension.
+
+	if (!write_file(m_filename, header, body))
+		return false;
+
+	m_file_hash = hash.get();
+	m_hashed_filename = m_filename;
+	m_file_identity = get_file_identity(m_filename);
+	return true;
+}
+
+//-------------------------------------------------------------------
+// This private function appends a member name to a JSON object being
+// written to a line, preceded by a comma if it is not the first.
+//-------------------------------------------------------------------
+// line: Buffer containing the JSON object.
+// name: Member name.
+//-------------------------------------------------------------------
+
+void write_json_name(std::string& line, const char* name)
+{
+	if (line.back() != '{')
+		line.push_back(',');
+
+	line.push_back('"');
+	line.append(name);
+	line.append("\":");
+}
+
+//----------------------------------------------------------
+// This private function appends a number member to a JSON
+// object being written to a line.
+//----------------------------------------------------------
+// line:  Buffer containing the JSON object.
+// name:  Member name.
+// value: Member value.
+//----------------------------------------------------------
+
+void write_json_member(std::string& line, const char* name, guint value)
+{
+	write_json_name(line, name);
+	line.append(std::to_string(value));
+}
+
+//----------------------------------------------------------
+// This private function appends a boolean member to a JSON
+// object being written to a line.
+//----------------------------------------------------------
+// line:  Buffer containing the JSON object.
+// name:  Member name.
+// value: Member value.
+//----------------------------------------------------------
+
+void write_json_member(std::string& line, const char* name, bool value)
+{
+	write_json_name(line, name);
+	line.append(value ? "true" : "false");
+}
+
+//-------------------------------------------------------------------
+// This private function appends a string member to a JSON object
+// being written to a line.  Quotes, backslashes and control
+// characters are escaped, so the string remains on a single line.
+//-------------------------------------------------------------------
+// line:  Buffer containing the JSON object.
+// name:  Member name.
+// value: Member value, in UTF-8.
+//-------------------------------------------------------------------
+
+void write_json_member(std::string& line,
+                       const char* name,
+                       const std::string& value)
+{
+	write_json_name(line, name);
+	line.push_back('"');
+
+	for (char character : value)
+	{
+		switch (character)
+		{
+			case '"':
+				line.append("\\\"");
+				break;
+
+			case '\\':
+				line.append("\\\\");
+				break;
+
+			case '\n':
+				line.append("\\n");
+				break;
+
+			case '\t':
+				line.append("\\t");
+				break;
+
+			default:
+				if ((guchar)character < 0x20)
+				{
+					gchar escape[7];
+					g_snprintf(escape, sizeof(escape), "\\u%04x", (guint)character);
+					line.append(escape);
+				}
+				else
+					line.push_back(character);
+
+				break;
+		}
+	}
+
+	line.push_back('"');
+}
+
+//-------------------------------------------------------------------
+// This private function appends a line describing an object to a
+// buffer.  Only data meaningful for the object's type is written,
+// and connection signal names are written only if present.
+//-------------------------------------------------------------------
+// buffer:  Buffer receiving the line.
+// element: Element name of the object.
+// object:  Object to be written.
+//-------------------------------------------------------------------
+
+void write_object_line(std::string& buffer,
+                       const char* element,
+                       const Enigma::Object& object)
+{
+	std::string line = "{";
+
+	write_json_member(line, "element", std::string(element));
+	write_json_member(line, "id", (guint)object.m_id);
+	write_json_member(line, "above", (guint)object.m_position.m_above);
+	write_json_member(line, "north", (guint)object.m_position.m_north);
+	write_json_member(line, "east", (guint)object.m_position.m_east);
+	write_json_member(line, "surface", (guint)object.m_surface);
+	write_json_member(line, "rotation", (guint)object.m_rotation);
+
+	if (object.m_type == Enigma::Object::Type::PLAYER)
+		write_json_member(line, "active", object.m_active);
+	else if (object.m_type == Enigma::Object::Type::ITEM)
+		write_json_member(line, "category", (guint)object.m_category);
+	else if (object.m_type == Enigma::Object::Type::TELEPORTER)
+	{
+		write_json_member(line, "arrival_surface", (guint)object.m_surface_arrival);
+		write_json_member(line, "arrival_rotation", (guint)object.m_rotation_arrival);
+		write_json_member(line, "arrival_above", (guint)object.m_position_arrival.m_above);
+		write_json_member(line, "arrival_north", (guint)object.m_position_arrival.m_north);
+		write_json_member(line, "arrival_east", (guint)object.m_position_arrival.m_east);
+	}
+
+	if (!object.m_sense.empty())
+		write_json_member(line, "sense", object.m_sense);
+
+	if (!object.m_state.empty())
+		write_json_member(line, "state", object.m_state);
+
+	if (!object.m_visibility.empty())
+		write_json_member(line, "visibility", object.m_visibility);
+
+	if (!object.m_presence.empty())
+		write_json_member(line, "presence", object.m_presence);
+
+	line.append("}\n");
+	buffer.append(line);
+}
+
+//-------------------------------------------------------------------
+// This private function appends the UTF-8 encoding of a character to
+// a string.
+//-------------------------------------------------------------------
+// string:    String receiving the character.
+// character: Unicode character.
+//-------------------------------------------------------------------
+
+void append_utf8(std::string& string, guint32 character)
+{
+	if (character < 0x80)
+		string.push_back((char)character);
+	else if (character < 0x800)
+	{
+		string.push_back((char)(0xc0 | (character >> 6)));
+		string.push_back((char)(0x80 | (character & 0x3f)));
+	}
+	else if (character < 0x10000)
+	{
+		string.push_back((char)(0xe0 | (character >> 12)));
+		string.push_back((char)(0x80 | ((character >> 6) & 0x3f)));
+		string.push_back((char)(0x80 | (character & 0x3f)));
+	}
+	else
+	{
+		string.push_back((char)(0xf0 | (character >> 18)));
+		string.push_back((char)(0x80 | ((character >> 12) & 0x3f)));
+		string.push_back((char)(0x80 | ((character >> 6) & 0x3f)));
+		string.push_back((char)(0x80 | (character & 0x3f)));
+	}
+}
+
+//---------------------------------------------------------------------
+// This private function reads a JSON string from a line, including
+// its quotes, and decodes its escape sequences.
+//---------------------------------------------------------------------
+// line:   Line containing the string.
+// index:  Index of the opening quote, which is moved just past the
+//         closing quote.
+// string: Buffer receiving the decoded string.
+// RETURN: TRUE if a valid string was read.
+//---------------------------------------------------------------------
+
+bool read_json_string(const std::string& line,
+                      gsize& index,
+                      std::string& string)
+{
+	string.clear();
+
+	if ((index >= line.size()) || (line[index] != '"'))
+		return false;
+
+	++ index;
+
+	while (index < line.size())
+	{
+		// Copy characters up to the closing quote or an escape sequence.
+
+		gsize end = line.find_first_of("\"\\", index);
+
+		if (end == std::string::npos)
+			return false;
+
+		string.append(line, index, end - index);
+		index = end + 1;
+
+		if (line[end] == '"')
+			return true;
+
+		if (index >= line.size())
+			return false;
+
+		char character = line[index ++];
+
+		switch (character)
+		{
+			case 'n':
+				string.push_back('\n');
+				break;
+
+			case 't':
+				string.push_back('\t');
+				break;
+
+			case 'r':
+				string.push_back('\r');
+				break;
+
+			case 'b':
+				string.push_back('\b');
+				break;
+
+			case 'f':
+				string.push_back('\f');
+				break;
+
+			case 'u':
+			{
+				if ((index + 4) > line.size())
+					return false;
+
+				guint32 value = g_ascii_strtoull(line.substr(index, 4).c_str(),
+				                                 nullptr,
+				                                 16);
+				index += 4;
+
+				// Combine a UTF-16 surrogate pair into one character.
+
+				if ((value >= 0xd800) && (value < 0xdc00)
+				    && ((index + 6) <= line.size())
+				    && (line.compare(index, 2, "\\u") == 0))
+				{
+					guint32 low = g_ascii_strtoull(line.substr(index + 2, 4).c_str(),
+					                               nullptr,
+					                               16);
+
+					if ((low >= 0xdc00) && (low < 0xe000))
+					{
+						value = 0x10000 + ((value - 0xd800) << 10) + (low - 0xdc00);
+						index += 6;
+					}
+				}
+
+				append_utf8(string, value);
+				break;
+			}
+
+			default:
+				// Quotes, backslashes and slashes stand for themselves.
+
+				string.push_back(character);
+				break;
+		}
+	}
+
+	return false;
+}
+
+//---------------------------------------------------------------------
+// This private function skips over spaces in a line.
+//---------------------------------------------------------------------
+// line:  Line to be examined.
+// index: Index into the line, which is moved past any spaces.
+//---------------------------------------------------------------------
+
+void skip_json_space(const std::string& line, gsize& index)
+{
+	while ((index < line.size())
+	       && ((line[index] == ' ') || (line[index] == '\t')
+	           || (line[index] == '\r')))
+	{
+		++ index;
+	}
+}
+
+//---------------------------------------------------------------------
+// This private function reads the next member of a JSON object from a
+// line.  Member values may be strings, unsigned numbers, or booleans
+// (read as 1 or 0).
+//---------------------------------------------------------------------
+// line:   Line containing the JSON object.
+// index:  Index just past the opening brace or previous member, which
+//         is moved past the member that is read.
+// name:   Buffer receiving the member name.
+// text:   Buffer receiving a string value.
+// value:  Receives a number or boolean value.
+// RETURN: TRUE if a member was read, or FALSE at the end of the object.
+//         The index is set to std::string::npos if the object is invalid.
+//---------------------------------------------------------------------
+
+bool read_json_member(const std::string& line,
+                      gsize& index,
+                      std::string& name,
+                      std::string& text,
+                      guint& value)
+{
+	bool first = (line[index - 1] == '{');
+	skip_json_space(line, index);
+
+	if ((index < line.size()) && (line[index] == '}'))
+	{
+		++ index;
+		return false;
+	}
+
+	// Members after the first are separated by commas.
+
+	if (!first)
+	{
+		if ((index >= line.size()) || (line[index] != ','))
+		{
+			index = std::string::npos;
+			return false;
+		}
+
+		++ index;
+		skip_json_space(line, index);
+	}
+
+	// Read the member name and its separating colon.
 
-			write_key_value_string(filedata,
-				                     Enigma::World::Key::PRESENCE,
-				                     (*object).m_presence);
+	if (!read_json_string(line, index, name))
+	{
+		index = std::string::npos;
+		return false;
 	}
 
-	//-----------------------------------------*
-	// Write KeyValues for all player objects. *
-	//-----------------------------------------*
+	skip_json_space(line, index);
 
-	for (object = m_players.begin();
-	     object != m_players.end();
-	     ++ object)
+	if ((index >= line.size()) || (line[index] != ':'))
 	{
-		// Add header for a player object.
+		index = std::string::npos;
+		return false;
+	}
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::PLAYER,
-		                     (guint8)(*object).m_id);
+	++ index;
+	skip_json_space(line, index);
 
-		// Write current, saved, and restart surface keyvalues.
-		// All have the same value.
+	// Read the member value.
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::SURFACE,
-		                     (guint8)(*object).m_surface);
+	text.clear();
+	value = 0;
 
-		if (m_savable)
+	if (index >= line.size())
+	{
+		index = std::string::npos;
+		return false;
+	}
+
+	if (line[index] == '"')
+	{
+		if (!read_json_string(line, index, text))
 		{
-			write_key_value_8bit(filedata,
-			                     Enigma::World::Key::SAVED,
-			                     (guint8)(*object).m_surface);
+			index = std::string::npos;
+			return false;
 		}
+	}
+	else if (line.compare(index, 4, "true") == 0)
+	{
+		value = 1;
+		index += 4;
+	}
+	else if (line.compare(index, 5, "false") == 0)
+		index += 5;
+	else if (g_ascii_isdigit(line[index]))
+	{
+		// Numbers too large to be held stay at the largest value, so they
+		// cannot wrap around into range.
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::RESTART,
-		                     (guint8)(*object).m_surface);
+		while ((index < line.size()) && g_ascii_isdigit(line[index]))
+		{
+			guint digit = line[index ++] - '0';
 
-		// Write current, saved, and restart rotation keyvalues.
-		// All have the same value.
+			if (value > ((G_MAXUINT - digit) / 10))
+				value = G_MAXUINT;
+			else
+				value = (value * 10) + digit;
+		}
+	}
+	else
+	{
+		index = std::string::npos;
+		return false;
+	}
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::ROTATION,
-		                     (guint8)(*object).m_rotation);
+	return true;
+}
 
-		if (m_savable)
-		{
-			write_key_value_8bit(filedata,
-			                     Enigma::World::Key::SAVED,
-			                     (guint8)(*object).m_rotation);
-		}
+//-------------------------------------------------------------------
+// This private method extracts one element from a line of a JSON
+// Lines text world file.  Objects are appended to their lists, which
+// are sorted afterwards if needed.  Blank lines are ignored, as are
+// unknown members so that files from newer programs can be read.
+//-------------------------------------------------------------------
+// line:   Line containing one JSON object.
+// RETURN: TRUE if the line was valid.
+//-------------------------------------------------------------------
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::RESTART,
-		                     (guint8)(*object).m_rotation);
+bool Enigma::World::extract_line(const std::string& line)
+{
+	gsize index = 0;
+	skip_json_space(line, index);
 
-		// Write current, saved, and restart East location keyvalues.
-		// All have the same value.
+	if (index >= line.size())
+		return true;
 
-		write_key_value_16bit(filedata,
-		                      Enigma::World::Key::EAST,
-		                      (*object).m_position.m_east);
+	if (line[index] != '{')
+		return false;
 
-		if (m_savable)
-		{
-			write_key_value_16bit(filedata,
-			                      Enigma::World::Key::SAVED,
-			                      (*object).m_position.m_east);
-		} 
+	++ index;
 
-		write_key_value_16bit(filedata,
-		                      Enigma::World::Key::RESTART,
-		                      (*object).m_position.m_east);
+	// Read all members of the line's JSON object.
 
-		// Write current, saved, and restart North location keyvalues.
-		// All have the same value.
+	std::string element;
+	std::string name;
+	std::string text;
+	guint value;
 
-		write_key_value_16bit(filedata,
-		                      Enigma::World::Key::NORTH,
-		                      (*object).m_position.m_north);
+	std::string controller_name;
+	std::string controller_source;
+	std::string description;
+	bool savable = false;
 
-		if (m_savable)
-		{
-			write_key_value_16bit(filedata,
-			                      Enigma::World::Key::SAVED,
-			                      (*object).m_position.m_north);
-		}
+	Enigma::Object object;
+	object.m_id               = Enigma::Object::ID::NONE;
+	object.m_position         = {0, 0, 0};
+	object.m_surface          = Enigma::Object::Direction::NONE;
+	object.m_rotation         = Enigma::Object::Direction::NONE;
+	object.m_active           = false;
+	object.m_category         = Enigma::Object::Category::NONE;
+	object.m_surface_arrival  = Enigma::Object::Direction::NONE;
+	object.m_rotation_arrival = Enigma::Object::Direction::NONE;
 
-		write_key_value_16bit(filedata,
-		                      Enigma::World::Key::RESTART,
-		                      (*object).m_position.m_north);
+	// A teleporter without an arrival position leaves the player in place,
+	// as in a world file.
 
-		// Write current, saved, and restart Above location keyvalues.
-		// All have the same value.
+	object.m_position_arrival.m_east  = Enigma::Position::MAXIMUM;
+	object.m_position_arrival.m_north = Enigma::Position::MAXIMUM;
+	object.m_position_arrival.m_above = Enigma::Position::MAXIMUM;
 
-		write_key_value_16bit(filedata,
-		                      Enigma::World::Key::ABOVE,
-		                      (*object).m_position.m_above);
+	// Position values are checked as they are read, before they are
+	// narrowed to fit a position.
 
-		if (m_savable)
+	bool in_range = true;
+
+	while (read_json_member(line, index, name, text, value))
+	{
+		if ((name == "above")
+		    || (name == "north")
+		    || (name == "east")
+		    || (name == "arrival_above")
+		    || (name == "arrival_north")
+		    || (name == "arrival_east"))
 		{
-			write_key_value_16bit(filedata,
-			                      Enigma::World::Key::SAVED,
-			                      (*object).m_position.m_above);
+			if (value > Enigma::Position::MAXIMUM)
+				in_range = false;
 		}
 
-		write_key_value_16bit(filedata,
-		                      Enigma::World::Key::RESTART,
-		                      (*object).m_position.m_above);
+		if (name == "element")
+			element = text;
+		else if (name == "id")
+			object.m_id = (Enigma::Object::ID)value;
+		else if (name == "above")
+			object.m_position.m_above = value;
+		else if (name == "north")
+			object.m_position.m_north = value;
+		else if (name == "east")
+			object.m_position.m_east = value;
+		else if (name == "surface")
+			object.m_surface = (Enigma::Object::Direction)value;
+		else if (name == "rotation")
+			object.m_rotation = (Enigma::Object::Direction)value;
+		else if (name == "active")
+			object.m_active = (bool)value;
+		else if (name == "category")
+			object.m_category = (Enigma::Object::Category)value;
+		else if (name == "arrival_surface")
+			object.m_surface_arrival = (Enigma::Object::Direction)value;
+		else if (name == "arrival_rotation")
+			object.m_rotation_arrival = (Enigma::Object::Direction)value;
+		else if (name == "arrival_above")
+			object.m_position_arrival.m_above = value;
+		else if (name == "arrival_north")
+			object.m_position_arrival.m_north = value;
+		else if (name == "arrival_east")
+			object.m_position_arrival.m_east = value;
+		else if (name == "sense")
+			object.m_sense = text;
+		else if (name == "state")
+			object.m_state = text;
+		else if (name == "visibility")
+			object.m_visibility = text;
+		else if (name == "presence")
+			object.m_presence = text;
+		else if (name == "name")
+			controller_name = text;
+		else if (name == "source")
+			controller_source = text;
+		else if (name == "text")
+			description = text;
+		else if (name == "savable")
+			savable = (bool)value;
+	}
 
-		// Add current, saved, and restart Active state keyvalues.
-		// All have the same value.
+	// A valid line ends with the object's closing brace.
 
-		write_key_value_boolean(filedata,
-			                      Enigma::World::Key::ACTIVE,
-			                      (*object).m_active);
+	if (index == std::string::npos)
+		return false;
 
-		if (m_savable)
-		{
-			write_key_value_boolean(filedata,
-				                      Enigma::World::Key::SAVED,
-				                      (*object).m_active);
-		}
+	skip_json_space(line, index);
 
-		write_key_value_boolean(filedata,
-		                        Enigma::World::Key::RESTART,
-		                        (*object).m_active);
+	if (index != line.size())
+		return false;
 
-		// Add object state or signal keyvalues.  Player objects
-		// do not have a Sense state or signal.
+	// Reject values out of range, as is done for keyvalue world files.
+	// Other views use the ID, directions and category as table indices.
 
-		write_key_value_string(filedata,
-		                       Enigma::World::Key::STATE,
-		                       (*object).m_state);
+	if (!in_range
+	    || ((guint)object.m_id >= (guint)Enigma::Object::ID::TOTAL)
+	    || ((guint)object.m_surface >= (guint)Enigma::Object::Direction::TOTAL)
+	    || ((guint)object.m_rotation >= (guint)Enigma::Object::Direction::TOTAL)
+	    || ((guint)object.m_category >= (guint)Enigma::Object::Category::TOTAL)
+	    || ((guint)object.m_surface_arrival
+	        >= (guint)Enigma::Object::Direction::TOTAL)
+	    || ((guint)object.m_rotation_arrival
+	        >= (guint)Enigma::Object::Direction::TOTAL))
+	{
+		return false;
+	}
 
-		write_key_value_string(filedata,
-		                       Enigma::World::Key::VISIBILITY,
-		                       (*object).m_visibility);
+	// Add the element to the world.
 
-		write_key_value_string(filedata,
-		                       Enigma::World::Key::PRESENCE,
-		                       (*object).m_presence);
+	if (element == "object")
+	{
+		object.m_type = Enigma::Object::Type::OBJECT;
+		m_objects.push_back(object);
+	}
+	else if (element == "teleporter")
+	{
+		object.m_type = Enigma::Object::Type::TELEPORTER;
+		m_teleporters.push_back(object);
+	}
+	else if (element == "player")
+	{
+		object.m_type = Enigma::Object::Type::PLAYER;
+		m_players.push_back(object);
+	}
+	else if (element == "item")
+	{
+		object.m_type = Enigma::Object::Type::ITEM;
+		m_items.push_back(object);
+	}
+	else if (element == "controller")
+	{
+		m_controllers.emplace_back(controller_name);
+		m_controllers.back().compile(controller_source);
 	}
+	else if (element == "description")
+		m_description = description;
+	else if (element == "world")
+		m_savable = savable;
+	else
+		return false;
 
-	//---------------------------------------*
-	// Write KeyValues for all item objects. *
-	//---------------------------------------*
+	return true;
+}
 
-	for (object = m_items.begin();
-	     object != m_items.end();
-	     ++ object)
-	{
-		// Add header for an item object.
+//---------------------------------------------------------------------
+// This private method loads a game world from a JSON Lines text file.
+// The file is read one block at a time, and each complete line is
+// extracted as it arrives, so the file is never held in memory.
+//---------------------------------------------------------------------
+// RETURN: TRUE if the file was loaded.
+//---------------------------------------------------------------------
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::ITEM,
-		                     (guint8)(*object).m_id);
+bool Enigma::World::load_lines()
+{
+	std::string filedata;
+	std::string line;
+	gsize start = 0;
+	gsize end;
+	gsize size;
+	Enigma::Hash hash;
+	bool appended = false;
 
-		// Write surface.
+	try
+	{
+		bool compressed;
+		Glib::RefPtr<Gio::InputStream> stream = open_file(m_filename, compressed);
 
-		write_key_value_8bit(filedata,
-		                      Enigma::World::Key::SURFACE,
-		                      (guint8)(*object).m_surface);
+		// Progress is measured through the file itself, whose size is known
+		// before reading.  A compressed file is read through a converter, so
+		// its position is found from the underlying file stream.
 
-		// Write rotation.
+		Glib::RefPtr<Gio::FileInputStream> file_stream =
+			Glib::RefPtr<Gio::FileInputStream>::cast_dynamic(compressed
+				? Glib::RefPtr<Gio::FilterInputStream>::cast_dynamic(stream)->get_base_stream()
+				: stream);
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::ROTATION,
-		                     (guint8)(*object).m_rotation);
+		m_load_size = file_stream->query_info(G_FILE_ATTRIBUTE_STANDARD_SIZE)->get_size();
 
-		// Write location.
+		do
+		{
+			// Keep any partial line at the end of the buffer, and read another
+			// block after it.
 
-		write_key_value_16bit(filedata,
-		                      Enigma::World::Key::EAST,
-		                      (*object).m_position.m_east);
+			filedata.erase(0, start);
+			start = 0;
+			size = filedata.size();
 
-		write_key_value_16bit(filedata,
-		                      Enigma::World::Key::NORTH,
-		                      (*object).m_position.m_north);
+			read_stream(stream, filedata, size + STREAM_BLOCK, m_cancel);
+			m_load_index = file_stream->tell();
 
-		write_key_value_16bit(filedata,
-		                      Enigma::World::Key::ABOVE,
-		                      (*object).m_position.m_above);
+			if (m_cancel)
+			{
+				clear();
+				return false;
+			}
 
-		// Write category.
+			// At the end of the file, the last line need not end with a newline.
 
-		write_key_value_8bit(filedata,
-		                     Enigma::World::Key::CATEGORY,
-		                     (guint8)(*object).m_category);
+			if ((filedata.size() == size) && (size > 0))
+			{
+				filedata.push_back('\n');
+				appended = true;
+			}
 
-		// Add current, saved, and restart active state keyvalues.
-		// All items begin as active (not yet found).
+			while ((end = filedata.find('\n', start)) != std::string::npos)
+			{
+				line.assign(filedata, start, end - start);
+				hash.add(filedata.data() + start, end + 1 - start);
 
-		write_key_value_boolean(filedata,
-		                        Enigma::World::Key::ACTIVE,
-		                        true);
+				if (!extract_line(line))
+				{
+					clear();
+					return false;
+				}
 
-		if (m_savable)
-		{
-			write_key_value_boolean(filedata,
-			                        Enigma::World::Key::SAVED,
-			                        true);
+				start = end + 1;
+			}
 		}
+		while (filedata.size() > size);
+	}
+	catch(Glib::Error error)
+	{
+		clear();
+		return false;
+	}
 
-		write_key_value_boolean(filedata,
-		                        Enigma::World::Key::RESTART,
-		                        true);
+	// Record the hash of the lines, as save_lines() finds it.  A file whose
+	// last line has no newline is never quite what save_lines() writes, so
+	// it has no file hash.
 
-		// Add object state or signal keyvalues.  Item objects
-		// do not have a Sense state or signal.
+	m_file_hash = appended ? 0 : hash.get();
+	m_hashed_filename = m_filename;
+	m_file_identity = get_file_identity(m_filename);
 
-		write_key_value_string(filedata,
-		                       Enigma::World::Key::STATE,
-		                       (*object).m_state);
+	sort_lists();
+	return true;
+}
 
-		write_key_value_string(filedata,
-		                       Enigma::World::Key::VISIBILITY,
-		                       (*object).m_visibility);
+//---------------------------------------------------------------------
+// This private function writes a game world as JSON Lines text, with
+// one line for each element.  Lines are written one block at a time,
+// so the text is never held in memory.  Controllers are written as
+// source code.  Each line is hashed as it is written, just as it is by
+// load_lines() when it is read.  A Glib::Error exception is thrown if
+// the text cannot be written.
+//---------------------------------------------------------------------
+// world:  Game world.
+// stream: Stream of file contents, or empty to only find the hash.
+// RETURN: Hash of the text.
+//---------------------------------------------------------------------
 
-		write_key_value_string(filedata,
-		                       Enigma::World::Key::PRESENCE,
-		                       (*object).m_presence);
+guint64 write_lines(Enigma::World& world,
+                    const Glib::RefPtr<Gio::OutputStream>& stream)
+{
+	Enigma::Hash hash;
+	std::string buffer;
+	std::string line;
+	gsize written;
+
+	// Write the world settings and description.
+
+	line = "{";
+	write_json_member(line, "element", std::string("world"));
+	write_json_member(line, "format", std::string("1.0"));
+	write_json_member(line, "savable", world.m_savable);
+	line.append("}\n");
+	buffer.append(line);
+	hash.add(line.data(), line.size());
+
+	line = "{";
+	write_json_member(line, "element", std::string("description"));
+	write_json_member(line, "text", world.m_description.raw());
+	line.append("}\n");
+	buffer.append(line);
+	hash.add(line.data(), line.size());
+
+	// Write the controllers.
+
+	std::list<Enigma::Controller>::iterator controller;
+	Glib::ustring sourcecode;
+
+	for (controller = world.m_controllers.begin();
+	     controller != world.m_controllers.end();
+	     ++ controller)
+	{
+		sourcecode.clear();
+		(*controller).uncompile(sourcecode);
+
+		line = "{";
+		write_json_member(line, "element", std::string("controller"));
+		write_json_member(line, "name", (*controller).m_name);
+		write_json_member(line, "source", sourcecode.raw());
+		line.append("}\n");
+		buffer.append(line);
+		hash.add(line.data(), line.size());
 	}
 
-	//-----------------------------------------
-	// Write KeyValues for the map description.
-	//-----------------------------------------
+	// Write all objects, in the sorted order of their lists.
 
-	// Add header for a description.
+	Enigma::ObjectList* lists[] =
+		{&world.m_objects, &world.m_teleporters, &world.m_players, &world.m_items};
 
-	write_key_value_8bit(filedata,
-	                     Enigma::World::Key::DESCRIPTION,
-	                     (guint8)Enigma::World::Language::ENGLISH);
+	const char* elements[] =
+		{"object", "teleporter", "player", "item"};
 
-	// Add description length keyvalue.
+	std::list<Enigma::Object>::iterator object;
 
-	write_key_value_16bit(filedata,
-	                      Enigma::World::Key::LENGTH,
-	                      (guint16)m_description.bytes());
+	for (int list = 0; list < 4; ++ list)
+	{
+		for (object = lists[list]->begin();
+		     object != lists[list]->end();
+		     ++ object)
+		{
+			gsize start = buffer.size();
 
-	// Write data keyvalue, followed by description in UTF-8 format.
+			write_object_line(buffer, elements[list], *object);
+			hash.add(buffer.data() + start, buffer.size() - start);
 
-	write_key_value_8bit(filedata,
-	                     Enigma::World::Key::DATA,
-	                     0);
+			if (buffer.size() >= STREAM_BLOCK)
+			{
+				if (stream)
+					stream->write_all(buffer.data(), buffer.size(), written);
 
-	filedata.append(m_description);
+				buffer.clear();
+			}
+		}
+	}
 
-	//---------------------------------
-	// Write KeyValue array terminator.
-	//---------------------------------
+	if (stream)
+	{
+		stream->write_all(buffer.data(), buffer.size(), written);
+		stream->close();
+	}
 
-	write_key_value_8bit(filedata,
-	                     Enigma::World::Key::END,
-	                     0);
+	return hash.get();
+}
 
-	// Write the file data to the file.
+//---------------------------------------------------------------------
+// This private method saves the game world to a JSON Lines text file.
+// If the file is still the one last read or written, the text is first
+// only hashed, and the file is not written again if it already holds
+// the same text.
+//---------------------------------------------------------------------
+// RETURN: TRUE if the file was saved.
+//---------------------------------------------------------------------
 
+bool Enigma::World::save_lines()
+{
 	try
 	{
-		Glib::file_set_contents(m_filename,
-		filedata.data(),
-		filedata.size());
+		if ((m_file_hash != 0)
+		    && (m_hashed_filename == m_filename.raw())
+		    && !m_file_identity.empty()
+		    && (get_file_identity(m_filename) == m_file_identity)
+		    && (write_lines(*this, Glib::RefPtr<Gio::OutputStream>()) == m_file_hash))
+		{
+			return true;
+		}
+
+		m_file_hash = write_lines(*this, create_file(m_filename));
 	}
 	catch(Glib::Error error)
 	{
-		return;
+		return false;
 	}
+
+	m_hashed_filename = m_filename;
+	m_file_identity = get_file_identity(m_filename);
+	return true;
 }
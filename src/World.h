@@ -20,6 +20,9 @@
 #ifndef __WORLD_H__
 #define __WORLD_H__
 
+#include <map>
+#include <set>
+#include <atomic>
 #include "ObjectList.h"
 #include "Controller.h"
 
@@ -74,12 +77,36 @@ namespace Enigma
 				TOTAL
 			};
 			
+			class Chunk           // Location of a chunk in a world file.
+			{
+				public:
+					goffset m_offset;  // Byte offset of chunk.
+					gsize m_length;    // Byte length of chunk.
+			};
+
+			class Changes         // Changes made by reloading a world file.
+			{
+				public:
+					std::list<Enigma::Position> m_positions;  // Changed positions.
+					bool m_lists;          // TRUE if teleporters, players or items changed.
+					bool m_controllers;    // TRUE if controllers changed.
+					bool m_description;    // TRUE if description or settings changed.
+			};
+
 			// Public methods.
 
 			World();
 			void clear();
-			void load();
-			void save();
+			bool load();
+			bool load_level(unsigned short above);
+			bool load_levels(const Enigma::Volume& volume);
+			bool load_levels();
+			std::set<unsigned short> get_unloaded_levels() const;
+			bool is_file_changed() const;
+			bool load_latest(const std::set<unsigned short>& unloaded);
+			void reload(Enigma::World& latest, Enigma::World::Changes& changes);
+			guint64 hash();
+			bool save();
 
 			// Public data.
 		
@@ -90,10 +117,64 @@ namespace Enigma
 			Enigma::ObjectList m_teleporters;    // Sorted teleporter list.
 			Glib::ustring m_description;         // Description of game world.
 			bool m_savable;                      // TRUE if game can be saved.
+			guint m_load_count;                  // Number of files loaded.
+			guint m_sort_count;                  // Number of lists re-sorted.
+			guint64 m_file_hash;                 // Hash of file data, or zero.
+			guint m_load_threads;                // Most threads used to extract
+			                                     // objects, or zero for one
+			                                     // per processor core.
+
+			// Loading progress, which may be read by another thread.  The
+			// progress index reaches the size when loading is done.  Setting
+			// the cancel flag makes load() stop early and return FALSE.
+
+			std::atomic<gsize> m_load_index;     // Progress index.
+			std::atomic<gsize> m_load_size;      // Progress size.
+			std::atomic<bool> m_cancel;          // TRUE to cancel loading.
 
 			// List of logic controllers.
 
 			std::list<Enigma::Controller> m_controllers;
+
+		private:
+			// Private methods.
+
+			bool extract_elements(const std::string& filedata,
+			                      guint index,
+			                      guint end,
+			                      Enigma::ObjectList& objects);
+
+			void sort_lists();
+			void hash_file(const std::string& filedata, guint index);
+
+			void save_controllers(std::string& filedata);
+
+			void save_objects(std::string& filedata,
+			                  std::list<Enigma::Object>::iterator first,
+			                  std::list<Enigma::Object>::iterator last);
+
+			void save_teleporters(std::string& filedata);
+			void save_players(std::string& filedata);
+			void save_items(std::string& filedata);
+			void save_description(std::string& filedata);
+
+			bool extract_line(const std::string& line);
+			bool load_lines();
+			bool save_lines();
+
+			// Private data.
+
+			std::string m_chunk_filename;        // Chunked world filename.
+			std::string m_hashed_filename;       // Filename of file hash.
+			std::string m_file_identity;         // Size and tag of hashed file.
+
+			// Chunks of levels not yet loaded, keyed by Above position.
+
+			std::map<unsigned short, Enigma::World::Chunk> m_chunks;
+
+			// Chunks of levels that could not be loaded, keyed by Above position.
+
+			std::map<unsigned short, Enigma::World::Chunk> m_failed_chunks;
 	};
 }
 
@@ -0,0 +1,285 @@
+// "World in the Wine Cellar" world creator for "Enigma in the Wine Cellar".
+// Copyright (C) 2021 Chris Sterne <chris_sterne@hotmail.com>
+//
+// This file contains the main entry point for the batch program, which
+// validates, reports on, and converts game world files without a display.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+#include <cerrno>
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <glibmm.h>
+#include <glibmm/timer.h>
+#include <giomm/init.h>
+#include "World.h"
+
+//-------------------
+// Local declarations
+//-------------------
+
+static const std::string program_name = "world-in-the-wine-cellar-batch";
+
+static const char* usage_text =
+"Usage: world-in-the-wine-cellar-batch [OPTION...] FILE...\n\
+Validate, report on, or convert game world files.\n\
+\n\
+  --validate      Check that each file loads completely (default)\n\
+  --stats         Print the contents, content hash and load time of\n\
+                  each file\n\
+  --normalize     Save each file again in place, sorted and repacked\n\
+  --convert=EXT   Save each file with its extension replaced by EXT\n\
+                  (ewc, ewci or jsonl, optionally followed by .gz)\n\
+  --jobs=N        Number of files processed at once (default: all cores)\n";
+
+class Options                 // Batch program options.
+{
+	public:
+		bool m_stats = false;       // TRUE to print file statistics.
+		bool m_normalize = false;   // TRUE to save files in place.
+		std::string m_convert;      // Extension of converted files.
+		guint m_jobs = 0;           // Number of worker threads.
+		guint m_load_threads = 0;   // Threads extracting each file.
+};
+
+class Result                  // Result of processing a file.
+{
+	public:
+		bool m_valid = false;       // TRUE if the file was processed.
+		std::string m_report;       // Text reported for the file.
+};
+
+//-----------------------------------------------------------------------
+// This function returns a filename with its world file extension
+// (".ewc", ".ewci" or ".jsonl", optionally followed by ".gz") replaced
+// by another.
+//-----------------------------------------------------------------------
+// filename:  Original filename.
+// extension: New extension, without a leading period.
+// RETURN:    New filename.
+//-----------------------------------------------------------------------
+
+std::string replace_extension(const std::string& filename,
+                              const std::string& extension)
+{
+	std::string name = filename;
+
+	if (Glib::str_has_suffix(name, ".gz"))
+		name.resize(name.size() - 3);
+
+	if (Glib::str_has_suffix(name, ".ewc"))
+		name.resize(name.size() - 4);
+	else if (Glib::str_has_suffix(name, ".ewci"))
+		name.resize(name.size() - 5);
+	else if (Glib::str_has_suffix(name, ".jsonl"))
+		name.resize(name.size() - 6);
+
+	return name + "." + extension;
+}
+
+//-----------------------------------------------------------------
+// This function loads, checks and optionally saves one world file.
+//-----------------------------------------------------------------
+// filename: Name of world file.
+// options:  Batch program options.
+// result:   Result of processing the file.
+//-----------------------------------------------------------------
+
+void process_file(const std::string& filename,
+                  const Options& options,
+                  Result& result)
+{
+	Enigma::World world;
+	Glib::Timer timer;
+
+	// Load the file completely, including all levels of a chunked file.
+
+	world.m_filename = filename;
+	world.m_load_threads = options.m_load_threads;
+	result.m_valid = world.load() && world.load_levels();
+
+	double load_time = timer.elapsed();
+
+	if (!result.m_valid)
+	{
+		result.m_report = filename + ": invalid or unreadable world file\n";
+		return;
+	}
+
+	if (options.m_stats)
+	{
+		// Count the levels containing structural objects.
+
+		guint levels = 0;
+		std::list<Enigma::Object>::iterator object;
+
+		for (object = world.m_objects.begin();
+		     object != world.m_objects.end();
+		     ++ object)
+		{
+			if ((object == world.m_objects.begin())
+			    || ((*object).m_position.m_above
+			        != (*std::prev(object)).m_position.m_above))
+			{
+				++ levels;
+			}
+		}
+
+		result.m_report = Glib::ustring::compose(
+			"%1: objects %2 levels %3 teleporters %4 players %5 items %6 "
+			"controllers %7 description %8 sorted %9",
+			filename,
+			world.m_objects.size(),
+			levels,
+			world.m_teleporters.size(),
+			world.m_players.size(),
+			world.m_items.size(),
+			world.m_controllers.size(),
+			world.m_description.bytes(),
+			world.m_sort_count).raw();
+
+		// Report the content hash, which identifies the world content
+		// regardless of the file format.
+
+		gchar hash[17];
+		g_snprintf(hash, sizeof(hash), "%016" G_GINT64_MODIFIER "x", world.hash());
+
+		result.m_report += Glib::ustring::compose(" hash %1 load_ms %2\n",
+			hash,
+			(int)(load_time * 1000)).raw();
+	}
+
+	// Save the world again, either in place or with a new extension.
+
+	if (!options.m_convert.empty())
+		world.m_filename = replace_extension(filename, options.m_convert);
+
+	if (options.m_normalize || !options.m_convert.empty())
+	{
+		if (!world.save())
+		{
+			result.m_valid = false;
+			result.m_report += world.m_filename.raw() + ": could not be saved\n";
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+// This function is the batch program's main entry point.  Files are
+// shared among worker threads, but are reported in command-line order.
+//----------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+	Glib::set_prgname(program_name);
+	Gio::init();
+
+	// Read options and filenames from the command line.
+
+	Options options;
+	std::vector<std::string> filenames;
+
+	for (int index = 1; index < argc; ++ index)
+	{
+		std::string argument = argv[index];
+
+		if (argument == "--validate")
+			continue;
+		else if (argument == "--stats")
+			options.m_stats = true;
+		else if (argument == "--normalize")
+			options.m_normalize = true;
+		else if (Glib::str_has_prefix(argument, "--convert="))
+			options.m_convert = argument.substr(10);
+		else if (Glib::str_has_prefix(argument, "--jobs="))
+		{
+			const gchar* number = argument.c_str() + 7;
+			gchar* end = nullptr;
+			errno = 0;
+			guint64 jobs = g_ascii_strtoull(number, &end, 10);
+
+			if (!g_ascii_isdigit(*number) || *end || errno || jobs > G_MAXUINT)
+			{
+				std::cerr << usage_text;
+				return 2;
+			}
+
+			options.m_jobs = jobs;
+		}
+		else if (Glib::str_has_prefix(argument, "--"))
+		{
+			std::cerr << usage_text;
+			return 2;
+		}
+		else
+			filenames.push_back(argument);
+	}
+
+	if (filenames.empty())
+	{
+		std::cerr << usage_text;
+		return 2;
+	}
+
+	// Process the files with one worker thread per processor core, unless
+	// told otherwise.
+
+	if (options.m_jobs == 0)
+		options.m_jobs = std::max(std::thread::hardware_concurrency(), 1u);
+
+	options.m_jobs = std::min(options.m_jobs, (guint)filenames.size());
+
+	// Files processed in parallel each extract their objects on a single
+	// thread, so the processor cores are not shared by more threads than
+	// there are cores.
+
+	if (options.m_jobs > 1)
+		options.m_load_threads = 1;
+
+	std::vector<Result> results(filenames.size());
+	std::vector<std::thread> workers;
+	std::atomic<gsize> next(0);
+
+	for (guint job = 0; job < options.m_jobs; ++ job)
+	{
+		workers.emplace_back([&]()
+		{
+			gsize file;
+
+			while ((file = next ++) < filenames.size())
+				process_file(filenames[file], options, results[file]);
+		});
+	}
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	// Report the results.
+
+	int status = 0;
+
+	for (Result& result : results)
+	{
+		std::cout << result.m_report;
+
+		if (!result.m_valid)
+			status = 1;
+	}
+
+	return status;
+}
@@ -0,0 +1,632 @@
+// "World in the Wine Cellar" world creator for "Enigma in the Wine Cellar".
+// Copyright (C) 2021 Chris Sterne <chris_sterne@hotmail.com>
+//
+// This file contains the main entry point for the benchmark program, which
+// generates a synthetic game world and times loading, saving and searching
+// it.  Results are printed as JSON Lines, one measurement on each line.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+#include <cerrno>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <glibmm.h>
+#include <glibmm/timer.h>
+#include <giomm/init.h>
+#include <giomm/file.h>
+#include "World.h"
+
+//-------------------
+// Local declarations
+//-------------------
+
+static const std::string program_name = "world-in-the-wine-cellar-bench";
+
+static const char* usage_text =
+"Usage: world-in-the-wine-cellar-bench [OPTION...]\n\
+Generate a synthetic game world, and time loading, saving and searching it.\n\
+Results are printed as JSON Lines.\n\
+\n\
+  --objects=N      Number of objects (default 100000)\n\
+  --levels=N       Number of levels (default 20)\n\
+  --density=N      Average number of objects in each room (default 2)\n\
+  --controllers=N  Number of controllers (default 50)\n\
+  --signals=N      Number of distinct signal names (default 200)\n\
+  --seed=N         Generator seed (default 1)\n\
+  --repeat=N       Times each measurement is repeated, keeping the\n\
+                   fastest (default 3)\n\
+  --searches=N     Number of searches for each search pattern\n\
+                   (default 200)\n\
+  --directory=DIR  Directory for temporary world files (default: the\n\
+                   system temporary directory)\n";
+
+class Options                 // Benchmark program options.
+{
+	public:
+		guint m_objects = 100000;   // Number of objects.
+		guint m_levels = 20;        // Number of levels.
+		guint m_density = 2;        // Average objects in each room.
+		guint m_controllers = 50;   // Number of controllers.
+		guint m_signals = 200;      // Number of distinct signal names.
+		guint64 m_seed = 1;         // Generator seed.
+		guint m_repeat = 3;         // Repetitions of each measurement.
+		guint m_searches = 200;     // Searches for each search pattern.
+		std::string m_directory;    // Directory for temporary files.
+};
+
+class Random                  // Deterministic random number generator.
+{
+	public:
+		//----------------------------------------------------------------
+		// This method is the constructor.  The same seed always produces
+		// the same numbers, on any system (xorshift64*).
+		//----------------------------------------------------------------
+		// seed: Generator seed.
+		//----------------------------------------------------------------
+
+		Random(guint64 seed) : m_state(seed ? seed : 1) {}
+
+		//-------------------------------------------------
+		// This method returns a number from 0 to limit - 1.
+		//-------------------------------------------------
+		// limit:  Limit of the number.
+		// RETURN: Random number.
+		//-------------------------------------------------
+
+		guint below(guint limit)
+		{
+			m_state ^= m_state >> 12;
+			m_state ^= m_state << 25;
+			m_state ^= m_state >> 27;
+
+			return (guint)(((m_state * 0x2545f4914f6cdd1dULL) >> 32) % limit);
+		}
+
+	private:
+		guint64 m_state;          // Generator state.
+};
+
+//-----------------------------------------------------------------
+// This function prints one measurement as a line of JSON.
+//-----------------------------------------------------------------
+// name:    Name of the measurement.
+// seconds: Fastest time taken.
+// count:   Number of items (objects, searches, etc.) processed.
+//-----------------------------------------------------------------
+
+void report(const std::string& name, double seconds, gsize count)
+{
+	gchar line[256];
+
+	g_snprintf(line,
+	           sizeof(line),
+	           "{\"benchmark\":\"%s\",\"seconds\":%.6f,\"count\":%lu,"
+	           "\"ns_per_item\":%.1f}\n",
+	           name.c_str(),
+	           seconds,
+	           (gulong)count,
+	           (count > 0) ? (seconds * 1e9) / count : 0.0);
+
+	std::cout << line << std::flush;
+}
+
+//---------------------------------------------------------------------
+// This function reads a whole decimal number from an option value.
+// Anything else, such as a sign, other characters, or a number larger
+// than the option can hold, is refused.
+//---------------------------------------------------------------------
+// value:   Option value.
+// maximum: Largest number accepted.
+// number:  Number read.
+// RETURN:  TRUE if the value is a valid number.
+//---------------------------------------------------------------------
+
+bool read_number(const std::string& value, guint64 maximum, guint64& number)
+{
+	const gchar* start = value.c_str();
+	gchar* end = nullptr;
+	errno = 0;
+	number = g_ascii_strtoull(start, &end, 10);
+
+	return g_ascii_isdigit(*start) && !*end && !errno && (number <= maximum);
+}
+
+//---------------------------------------------------------------------
+// This function returns the length of the square area of rooms that
+// holds each level's objects at the requested density.
+//---------------------------------------------------------------------
+// options: Benchmark program options.
+// RETURN:  Number of rooms along each side of a level.
+//---------------------------------------------------------------------
+
+guint level_side(const Options& options)
+{
+	double rooms = (double)options.m_objects
+	             / std::max(options.m_levels, 1u)
+	             / std::max(options.m_density, 1u);
+
+	return std::max((guint)std::ceil(std::sqrt(rooms)), 1u);
+}
+
+//---------------------------------------------------------------------
+// This function returns a random position within the generated world.
+//---------------------------------------------------------------------
+// random:  Random number generator.
+// options: Benchmark program options.
+// RETURN:  Random position.
+//---------------------------------------------------------------------
+
+Enigma::Position random_position(Random& random, const Options& options)
+{
+	guint side = level_side(options);
+	Enigma::Position position;
+
+	position.m_above = random.below(std::max(options.m_levels, 1u));
+	position.m_north = random.below(side);
+	position.m_east  = random.below(side);
+
+	return position;
+}
+
+//---------------------------------------------------------------------
+// This function fills a world with randomly placed objects, items,
+// players, teleporters and controllers.  About one object in ten is
+// connected to a controller signal.  The same options always generate
+// the same world.
+//---------------------------------------------------------------------
+// world:   World to be filled.
+// options: Benchmark program options.
+//---------------------------------------------------------------------
+
+void generate_world(Enigma::World& world, const Options& options)
+{
+	Random random(options.m_seed);
+	guint signals = std::max(options.m_signals, 1u);
+	guint controllers = std::max(options.m_controllers, 1u);
+
+	world.clear();
+	world.m_description = "Synthetic benchmark world";
+	world.m_savable = false;
+
+	for (guint count = 0; count < options.m_controllers; ++ count)
+	{
+		Enigma::Controller controller("controller" + std::to_string(count));
+
+		std::string sourcecode = "[Restart]\nT > signal"
+			+ std::to_string(random.below(signals))
+			+ "\n[Main]\nsignal" + std::to_string(random.below(signals))
+			+ " & signal" + std::to_string(random.below(signals))
+			+ " > signal" + std::to_string(random.below(signals)) + "\n";
+
+		controller.compile(sourcecode);
+		world.m_controllers.push_back(controller);
+	}
+
+	Enigma::Object object;
+
+	for (guint count = 0; count < options.m_objects; ++ count)
+	{
+		object.m_position = random_position(random, options);
+		object.m_id = (Enigma::Object::ID)(1 + random.below(
+			(guint)Enigma::Object::ID::TOTAL - 1));
+		object.m_surface = (Enigma::Object::Direction)(1 + random.below(6));
+		object.m_rotation = (Enigma::Object::Direction)(1 + random.below(4));
+		object.m_active = false;
+		object.m_category = Enigma::Object::Category::NONE;
+		object.m_surface_arrival = Enigma::Object::Direction::NONE;
+		object.m_rotation_arrival = Enigma::Object::Direction::NONE;
+		object.m_position_arrival = object.m_position;
+		object.m_state.clear();
+
+		if (random.below(10) == 0)
+		{
+			object.m_state = "controller" + std::to_string(random.below(controllers))
+			               + ":signal" + std::to_string(random.below(signals));
+		}
+
+		// Objects are appended unsorted, then sorted once.
+
+		switch (random.below(100))
+		{
+			case 0:
+				object.m_type = Enigma::Object::Type::PLAYER;
+				object.m_active = (world.m_players.empty());
+				world.m_players.push_back(object);
+				break;
+
+			case 1:
+				object.m_type = Enigma::Object::Type::TELEPORTER;
+				object.m_position_arrival = random_position(random, options);
+				world.m_teleporters.push_back(object);
+				break;
+
+			case 2:
+			case 3:
+				object.m_type = Enigma::Object::Type::ITEM;
+				object.m_category = (Enigma::Object::Category)(1 + random.below(4));
+				world.m_items.push_back(object);
+				break;
+
+			default:
+				object.m_type = Enigma::Object::Type::OBJECT;
+				world.m_objects.push_back(object);
+				break;
+		}
+	}
+
+	world.m_objects.sort();
+	world.m_players.sort();
+	world.m_teleporters.sort();
+	world.m_items.sort();
+}
+
+//---------------------------------------------------------------------
+// This function times saving and loading a world in one file format.
+//---------------------------------------------------------------------
+// world:     World to be saved.
+// extension: Extension of the file format.
+// options:   Benchmark program options.
+//---------------------------------------------------------------------
+
+void time_file(Enigma::World& world,
+               const std::string& extension,
+               const Options& options)
+{
+	std::string filename =
+		Glib::build_filename(options.m_directory, program_name + "." + extension);
+
+	std::string name = extension;
+	std::replace(name.begin(), name.end(), '.', '_');
+
+	gsize count = world.m_objects.size() + world.m_items.size()
+	            + world.m_players.size() + world.m_teleporters.size();
+
+	Glib::Timer timer;
+	double best;
+
+	// Time saving.  The file hash is cleared each time, so the file is
+	// really written.
+
+	world.m_filename = filename;
+	best = G_MAXDOUBLE;
+
+	for (guint repeat = 0; repeat < options.m_repeat; ++ repeat)
+	{
+		world.m_file_hash = 0;
+		timer.start();
+
+		if (!world.save())
+		{
+			std::cerr << filename << ": could not be saved\n";
+			return;
+		}
+
+		best = std::min(best, timer.elapsed());
+	}
+
+	report("save_" + name, best, count);
+
+	// Time loading the file completely.
+
+	best = G_MAXDOUBLE;
+
+	for (guint repeat = 0; repeat < options.m_repeat; ++ repeat)
+	{
+		Enigma::World loaded;
+		loaded.m_filename = filename;
+		timer.start();
+
+		if (!loaded.load() || !loaded.load_levels())
+		{
+			std::cerr << filename << ": could not be loaded\n";
+			return;
+		}
+
+		best = std::min(best, timer.elapsed());
+	}
+
+	report("load_" + name, best, count);
+
+	// A chunked file loads only its main chunk at first.
+
+	if (extension == "ewci")
+	{
+		best = G_MAXDOUBLE;
+
+		for (guint repeat = 0; repeat < options.m_repeat; ++ repeat)
+		{
+			Enigma::World loaded;
+			loaded.m_filename = filename;
+			timer.start();
+			loaded.load();
+			loaded.load_level(0);
+			best = std::min(best, timer.elapsed());
+		}
+
+		report("load_" + name + "_first_level", best, count);
+	}
+
+	try
+	{
+		Gio::File::create_for_path(filename)->remove();
+	}
+	catch(Glib::Error error)
+	{
+	}
+}
+
+//---------------------------------------------------------------------
+// This function times reading objects with several search patterns,
+// which exercise the object list's cached search position differently.
+//---------------------------------------------------------------------
+// world:   World to be searched.
+// options: Benchmark program options.
+//---------------------------------------------------------------------
+
+void time_searches(Enigma::World& world, const Options& options)
+{
+	std::vector<Enigma::Position> positions(options.m_searches);
+	std::list<std::list<Enigma::Object>::iterator> buffer;
+	Glib::Timer timer;
+	double best;
+
+	Random random(options.m_seed + 1);
+	guint side = level_side(options);
+
+	// Patterns: rooms in sorted order, rooms at random, and rooms on
+	// alternating levels (the worst case for the cached search position).
+
+	const char* names[] = {"read_sequential", "read_random", "read_level_jump"};
+
+	for (int pattern = 0; pattern < 3; ++ pattern)
+	{
+		for (guint index = 0; index < positions.size(); ++ index)
+		{
+			if (pattern == 0)
+			{
+				positions[index].m_above = (index / (side * side)) % options.m_levels;
+				positions[index].m_north = (index / side) % side;
+				positions[index].m_east  = index % side;
+			}
+			else if (pattern == 1)
+				positions[index] = random_position(random, options);
+			else
+			{
+				positions[index] = random_position(random, options);
+				positions[index].m_above = (index % 2) ? options.m_levels - 1 : 0;
+			}
+		}
+
+		best = G_MAXDOUBLE;
+
+		for (guint repeat = 0; repeat < options.m_repeat; ++ repeat)
+		{
+			timer.start();
+
+			for (Enigma::Position& position : positions)
+			{
+				buffer.clear();
+				world.m_objects.read(position, buffer);
+			}
+
+			best = std::min(best, timer.elapsed());
+		}
+
+		report(names[pattern], best, positions.size());
+	}
+}
+
+//---------------------------------------------------------------------
+// This function times reading, copying and pasting volumes of rooms,
+// as the level viewer does when marking, copying and pasting.
+//---------------------------------------------------------------------
+// world:   World to be used.
+// options: Benchmark program options.
+//---------------------------------------------------------------------
+
+void time_volumes(Enigma::World& world, const Options& options)
+{
+	const guint VOLUMES = 100;
+	const guint SIZE = 16;
+
+	std::vector<Enigma::Volume> volumes(VOLUMES);
+	Random random(options.m_seed + 2);
+
+	for (Enigma::Volume& volume : volumes)
+	{
+		volume.m_WSB = random_position(random, options);
+		volume.m_ENA = volume.m_WSB;
+		volume.m_ENA.m_north += SIZE - 1;
+		volume.m_ENA.m_east  += SIZE - 1;
+	}
+
+	std::list<std::list<Enigma::Object>::iterator> marked;
+	std::list<Enigma::Object> buffer;
+	Glib::Timer timer;
+	double best;
+
+	best = G_MAXDOUBLE;
+
+	for (guint repeat = 0; repeat < options.m_repeat; ++ repeat)
+	{
+		timer.start();
+
+		for (Enigma::Volume& volume : volumes)
+		{
+			marked.clear();
+			world.m_objects.read(volume, marked);
+		}
+
+		best = std::min(best, timer.elapsed());
+	}
+
+	report("read_volume", best, volumes.size());
+
+	best = G_MAXDOUBLE;
+
+	for (guint repeat = 0; repeat < options.m_repeat; ++ repeat)
+	{
+		timer.start();
+
+		for (Enigma::Volume& volume : volumes)
+		{
+			buffer.clear();
+			world.m_objects.copy(volume, buffer);
+		}
+
+		best = std::min(best, timer.elapsed());
+	}
+
+	report("copy_volume", best, volumes.size());
+
+	// Paste each copied volume into the levels above the generated world,
+	// inserting objects one at a time as the level viewer does.  Pasted
+	// objects are never copied again.  Pasting changes the world, so it is
+	// done only once.
+
+	timer.start();
+
+	for (Enigma::Volume& volume : volumes)
+	{
+		buffer.clear();
+		world.m_objects.copy(volume, buffer);
+
+		for (Enigma::Object& object : buffer)
+		{
+			object.m_position.m_above += options.m_levels;
+			world.m_objects.insert(object);
+		}
+	}
+
+	report("paste_volume", timer.elapsed(), volumes.size());
+}
+
+//----------------------------------------------------------------------
+// This function is the benchmark program's main entry point.
+//----------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+	Glib::set_prgname(program_name);
+	Gio::init();
+
+	// Read options from the command line.
+
+	Options options;
+	options.m_directory = Glib::get_tmp_dir();
+
+	for (int index = 1; index < argc; ++ index)
+	{
+		std::string argument = argv[index];
+		std::string value = argument.substr(argument.find('=') + 1);
+
+		// Numeric options are read into the matching option below.
+
+		guint* field = nullptr;
+		guint64 number = 0;
+		bool valid = true;
+
+		if (Glib::str_has_prefix(argument, "--objects="))
+			field = &options.m_objects;
+		else if (Glib::str_has_prefix(argument, "--levels="))
+			field = &options.m_levels;
+		else if (Glib::str_has_prefix(argument, "--density="))
+			field = &options.m_density;
+		else if (Glib::str_has_prefix(argument, "--controllers="))
+			field = &options.m_controllers;
+		else if (Glib::str_has_prefix(argument, "--signals="))
+			field = &options.m_signals;
+		else if (Glib::str_has_prefix(argument, "--seed="))
+		{
+			valid = read_number(value, G_MAXUINT64, number);
+			options.m_seed = number;
+		}
+		else if (Glib::str_has_prefix(argument, "--repeat="))
+			field = &options.m_repeat;
+		else if (Glib::str_has_prefix(argument, "--searches="))
+			field = &options.m_searches;
+		else if (Glib::str_has_prefix(argument, "--directory="))
+			options.m_directory = value;
+		else
+			valid = false;
+
+		if (field)
+		{
+			valid = read_number(value, G_MAXUINT, number);
+			*field = number;
+		}
+
+		if (!valid)
+		{
+			std::cerr << usage_text;
+			return 2;
+		}
+	}
+
+	options.m_levels = std::min(std::max(options.m_levels, 1u), 32767u);
+	options.m_repeat = std::max(options.m_repeat, 1u);
+
+	// Describe the generated world on the first line.
+
+	gchar line[256];
+
+	g_snprintf(line,
+	           sizeof(line),
+	           "{\"world\":{\"objects\":%u,\"levels\":%u,\"density\":%u,"
+	           "\"controllers\":%u,\"signals\":%u,\"seed\":%lu}}\n",
+	           options.m_objects,
+	           options.m_levels,
+	           options.m_density,
+	           options.m_controllers,
+	           options.m_signals,
+	           (gulong)options.m_seed);
+
+	std::cout << line;
+
+	Enigma::World world;
+	Glib::Timer timer;
+
+	generate_world(world, options);
+	report("generate", timer.elapsed(), options.m_objects);
+
+	time_file(world, "ewc", options);
+	time_file(world, "ewc.gz", options);
+	time_file(world, "ewci", options);
+	time_file(world, "jsonl", options);
+
+	// Saving a world whose file already holds the same data is skipped.
+
+	world.m_filename =
+		Glib::build_filename(options.m_directory, program_name + ".ewc");
+	world.save();
+
+	timer.start();
+	world.save();
+	report("save_ewc_unchanged", timer.elapsed(), world.m_objects.size());
+
+	try
+	{
+		Gio::File::create_for_path(world.m_filename)->remove();
+	}
+	catch(Glib::Error error)
+	{
+	}
+
+	time_searches(world, options);
+	time_volumes(world, options);
+
+	return 0;
+}